@@ -0,0 +1,219 @@
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "allocation.hpp"
+
+namespace {
+    // Each thread counts its own, so this doesn't need to be atomic. (The
+    // collector's marking threads allocate.)
+    thread_local constinit size_t allocation_count{0};
+
+    void* allocate(std::size_t size)
+    {
+        ++allocation_count;
+        if (0 == size) size = 1;
+        if (auto p = std::malloc(size)) return p;
+        throw std::bad_alloc{};
+    }
+
+    void* allocate(std::size_t size, std::align_val_t alignment)
+    {
+        ++allocation_count;
+        auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc requires the size to be a multiple of the alignment
+        size = (size + align - 1) / align * align;
+        if (0 == size) size = align;
+        if (auto p = std::aligned_alloc(align, size)) return p;
+        throw std::bad_alloc{};
+    }
+}
+
+size_t get_allocation_count() { return allocation_count; }
+
+namespace {
+    constexpr std::size_t pool_class_count{pool_max_size / pool_granularity};
+
+    struct free_block {
+        free_block* next;
+    };
+
+    // Slabs are aligned to their size, so the slab that a block belongs to
+    // can be found by masking the block's address. The header is at the
+    // start, and the blocks follow it.
+    struct slab {
+        // Links in the size class's list of slabs that have room
+        slab* next;
+        slab* prev;
+        free_block* free_list;
+        // The part of the slab that hasn't been handed out yet
+        std::byte* unused;
+        std::uint32_t live;
+        std::uint32_t index;
+    };
+
+    constexpr std::size_t slab_header_size{
+        (sizeof(slab) + pool_granularity - 1) / pool_granularity * pool_granularity};
+
+    struct size_class {
+        // Slabs with a free block or unused space. Full slabs aren't linked
+        // anywhere until one of their blocks is freed.
+        slab* available;
+        size_t live;
+        size_t free;
+    };
+
+    // This is zero-initialized and trivially destructible, so using it
+    // doesn't need a guard, and it is never destroyed out from under objects
+    // that are still alive.
+    struct object_pool {
+        std::array<size_class, pool_class_count> classes;
+        // Slabs that have nothing in them, linked through next. Any size
+        // class can reuse these.
+        slab* empty;
+        size_t empty_count;
+        size_t reserved_bytes;
+    };
+
+    thread_local constinit object_pool pool{};
+
+    // Size classes are numbered from zero, for 1 to pool_granularity bytes.
+    std::size_t size_class_index(std::size_t size)
+    {
+        if (0 == size) size = 1;
+        return (size - 1) / pool_granularity;
+    }
+
+    std::size_t block_size(std::size_t index)
+    { return (index + 1) * pool_granularity; }
+
+    slab* slab_of(void* p)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<slab*>(address & ~(pool_slab_size - 1));
+    }
+
+    std::byte* slab_end(slab* s)
+    { return reinterpret_cast<std::byte*>(s) + pool_slab_size; }
+
+    void link(size_class& sc, slab* s)
+    {
+        s->prev = nullptr;
+        s->next = sc.available;
+        if (sc.available) sc.available->prev = s;
+        sc.available = s;
+    }
+
+    void unlink(size_class& sc, slab* s)
+    {
+        if (s->prev) s->prev->next = s->next;
+        else sc.available = s->next;
+        if (s->next) s->next->prev = s->prev;
+    }
+
+    bool is_full(slab* s)
+    {
+        return (not s->free_list)
+            and (static_cast<std::size_t>(slab_end(s) - s->unused) < block_size(s->index));
+    }
+
+    slab* new_slab(std::size_t index)
+    {
+        void* memory = pool.empty;
+        if (memory) {
+            pool.empty = pool.empty->next;
+            --pool.empty_count;
+        } else {
+            memory = std::aligned_alloc(pool_slab_size, pool_slab_size);
+            if (not memory) throw std::bad_alloc{};
+            pool.reserved_bytes += pool_slab_size;
+        }
+        auto s = ::new (memory) slab{};
+        s->unused = reinterpret_cast<std::byte*>(s) + slab_header_size;
+        s->index = static_cast<std::uint32_t>(index);
+        return s;
+    }
+}
+
+void* pool_allocate(std::size_t size)
+{
+    if (size > pool_max_size) return ::operator new(size);
+    ++allocation_count;
+    auto index = size_class_index(size);
+    auto& sc = pool.classes[index];
+    if (not sc.available) link(sc, new_slab(index));
+    auto s = sc.available;
+    void* p;
+    if (s->free_list) {
+        p = s->free_list;
+        s->free_list = s->free_list->next;
+        --sc.free;
+    } else {
+        p = s->unused;
+        s->unused += block_size(index);
+    }
+    ++s->live;
+    ++sc.live;
+    if (is_full(s)) unlink(sc, s);
+    return p;
+}
+
+void pool_deallocate(void* p, std::size_t size) noexcept
+{
+    if (not p) return;
+    if (size > pool_max_size) return ::operator delete(p, size);
+    auto s = slab_of(p);
+    auto& sc = pool.classes[s->index];
+    if (is_full(s)) link(sc, s);
+    s->free_list = ::new (p) free_block{s->free_list};
+    --s->live;
+    --sc.live;
+    ++sc.free;
+    // Move an empty slab to the empty list, unless it's the only room this
+    // size class has left, so that allocating and freeing one object in a
+    // loop doesn't take a slab on and off the list each time.
+    if ((0 == s->live) and ((sc.available != s) or s->next)) {
+        unlink(sc, s);
+        sc.free -= (s->unused - reinterpret_cast<std::byte*>(s) - slab_header_size)
+            / block_size(s->index);
+        s->next = pool.empty;
+        pool.empty = s;
+        ++pool.empty_count;
+    }
+}
+
+void pool_trim() noexcept
+{
+    while (auto s = pool.empty) {
+        pool.empty = s->next;
+        pool.reserved_bytes -= pool_slab_size;
+        std::free(s);
+    }
+    pool.empty_count = 0;
+}
+
+pool_stats get_pool_stats()
+{
+    pool_stats stats;
+    for (std::size_t index = 0; index < pool_class_count; ++index) {
+        const auto& sc = pool.classes[index];
+        stats.live_objects += sc.live;
+        stats.live_bytes += sc.live * block_size(index);
+        stats.free_bytes += sc.free * block_size(index);
+    }
+    stats.empty_bytes = pool.empty_count * pool_slab_size;
+    stats.reserved_bytes = pool.reserved_bytes;
+    return stats;
+}
+
+// The array and nothrow forms of operator new are specified to call these, so
+// replacing these is enough to count everything.
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment)
+{ return allocate(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+// The global operator new is replaced (see allocation.cpp) so that we can
+// count heap allocations. This is cheap enough to always be on, and lets tests
+// check that a code path doesn't allocate.
+//
+// Allocations from the object pool are counted too. Only the calling thread's
+// allocations are counted.
+size_t get_allocation_count();
+
+// Counts the allocations made during its lifetime.
+class allocation_counter final {
+    size_t start;
+public:
+    allocation_counter(): start{get_allocation_count()} {}
+    size_t count() const { return get_allocation_count() - start; }
+};
+
+// Object pool
+//
+// value and environment are allocated from here (through their class-specific
+// operator new) instead of from the general heap. Sizes are rounded up to a
+// multiple of pool_granularity, and each of those size classes has its own
+// slabs of pool_slab_size bytes, each with its own free list. Once everything
+// in a slab has been freed, the slab can be reused by any size class, and
+// pool_trim gives those slabs back to the heap. (Giving them back right away
+// turned out to cost more than the rest of the allocator, when a big list is
+// discarded and another one is made.)
+//
+// Each thread has its own pool. An object must be freed on the thread that
+// allocated it.
+inline constexpr std::size_t pool_granularity{16};
+inline constexpr std::size_t pool_max_size{256};
+inline constexpr std::size_t pool_slab_size{64 * 1024};
+
+void* pool_allocate(std::size_t size);
+void pool_deallocate(void* p, std::size_t size) noexcept;
+// Frees the calling thread's empty slabs
+void pool_trim() noexcept;
+
+// Statistics for the calling thread's pool
+struct pool_stats {
+    // Objects handed out and not yet freed, and the bytes of their blocks
+    size_t live_objects{0};
+    size_t live_bytes{0};
+    // Freed blocks waiting to be reused
+    size_t free_bytes{0};
+    // Slabs with nothing in them, until pool_trim
+    size_t empty_bytes{0};
+    // Total size of the slabs
+    size_t reserved_bytes{0};
+
+    // The fraction of the slabs that isn't holding live objects. This
+    // includes free blocks of one size class that can't be used for another,
+    // the parts of slabs that haven't been carved into blocks yet, and empty
+    // slabs.
+    double fragmentation() const
+    {
+        if (0 == reserved_bytes) return 0;
+        return 1 - static_cast<double>(live_bytes) / reserved_bytes;
+    }
+};
+
+pool_stats get_pool_stats();
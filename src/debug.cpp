@@ -1,81 +1,86 @@
+#include <algorithm>
 #include <format>
 #include <ranges>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "debug.hpp"
 
-// Currently, the only data here is the color.
-// But this also defines what choices there are.
-std::unordered_map<std::string, std::string> debug_categories{
-    {"eval", "\033[36m"},        // Cyan
-    {"env_lookup", "\033[32m"},  // Green
-    {"env_binding", "\033[33m"}, // Yellow
-    {"env_dump", "\033[35m"},    // Magenta
-    {"operative", "\033[34m"},   // Blue
-    {"builtin", "\033[90m"},     // Dark gray
-    {"parse", "\033[31m"},       // Red
-    {"library", "\033[95m"},     // Light magenta
-    {"error", "\033[91m"},       // Light red
-    {"stack-depth", "\033[0m"},  // Reset
-    {"gc", "\033[0m"},           // Reset
-    {"tco", "\033[0m"},          // Reset
-    {"timer", "\033[0m"},        // Reset
-    {"gc_roots", "\033[0m"},     // Reset
-    {"all", "\033[0m"},          // Reset
-    {"none", "\033[0m"},         // Reset
-};
+namespace {
 
-// Global debug controller
-debug_controller& get_debug()
+const debug_category_info* find_category(std::string_view name)
 {
-    static debug_controller instance;
-    return instance;
+    auto iter = std::ranges::find(debug_categories, name, &debug_category_info::name);
+    if (iter == debug_categories.end()) return nullptr;
+    return &*iter;
 }
 
-void debug_controller::enable(const std::string& category)
+const debug_category_info& get_category(std::string_view name)
 {
-    if (not debug_categories.contains(category)) {
-        throw std::runtime_error("Unknown debug category: " + category);
+    auto info = find_category(name);
+    if (not info) {
+        throw std::runtime_error("Unknown debug category: " + std::string{name});
     }
-    enabled_categories.insert(category);
+    return *info;
 }
 
-void debug_controller::disable(const std::string& category)
-{ enabled_categories.erase(category); }
+} // namespace
 
-std::unordered_set<std::string> debug_controller::get_enabled_categories() const
-{ return enabled_categories; }
+void debug_controller::enable(const std::string& category)
+{
+    if ("all" == category) return enable_all();
+    if ("none" == category) return disable_all();
+    enabled_mask |= std::to_underlying(get_category(category).category);
+}
 
-void debug_controller::set_enabled_categories(const std::unordered_set<std::string>& categories)
-{ enabled_categories = categories; }
+void debug_controller::disable(const std::string& category)
+{
+    if ("all" == category) return disable_all();
+    if ("none" == category) return;
+    enabled_mask &= ~std::to_underlying(get_category(category).category);
+}
+
+std::vector<std::string> debug_controller::get_enabled_categories() const
+{
+    std::vector<std::string> enabled;
+    for (const auto& info: debug_categories) {
+        if (is_enabled(info.category)) enabled.emplace_back(info.name);
+    }
+    return enabled;
+}
 
 void debug_controller::enable_all()
-{ enabled_categories = std::views::keys(debug_categories) | std::ranges::to<std::unordered_set>(); }
+{
+    for (const auto& info: debug_categories) {
+        enabled_mask |= std::to_underlying(info.category);
+    }
+}
 
 void debug_controller::disable_all()
-{ enabled_categories.clear(); }
-
-bool debug_controller::is_enabled(const std::string& category) const
-{ return enabled_categories.contains(category); }
+{ enabled_mask = 0; }
 
 void debug_controller::set_colors(bool enable) { use_colors = enable; }
 bool debug_controller::are_colors_enabled() const { return use_colors; }
 
-// The parameter cannot (yet) be a string_view because unordered_map
-// doesn't (yet) support heterogeneous lookups.
-std::string debug_controller::get_prefix(const std::string& category) const
+const debug_category_info& debug_controller::get_info(debug_category category)
 {
-    if (not debug_categories.contains(category)) {
-        throw std::runtime_error("Unknown debug category: " + category);
+    auto iter = std::ranges::find(debug_categories, category, &debug_category_info::category);
+    if (iter == debug_categories.end()) {
+        throw std::runtime_error(std::format("Unknown debug category: {}",
+            std::to_underlying(category)));
     }
+    return *iter;
+}
+
+std::string debug_controller::get_prefix(debug_category category) const
+{
     //TODO: Do we want to make this uppercase?
-    return std::format("[{}]", category);
+    return std::format("[{}]", get_info(category).name);
 }
 
-std::string debug_controller::get_color(const std::string& category) const
+std::string_view debug_controller::get_color(debug_category category) const
 {
-    return debug_categories.at(category);
+    return get_info(category).color;
 }
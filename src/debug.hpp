@@ -1,52 +1,125 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <format>
 #include <print>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-#define NOEVAL_DEBUG(category, ...) get_debug().log(#category, __VA_ARGS__)
-#define NOEVAL_DEBUG_ENABLED(category) get_debug().is_enabled(#category)
+// The arguments after the category are only evaluated when the category is
+// enabled, so it is fine to pass expensive things like value_to_string(expr).
+//
+// Defining NOEVAL_NO_DEBUG compiles the logging out entirely. The category
+// and arguments are still seen by the compiler (so they stay type-checked and
+// variables used only for logging don't trigger warnings), but they are dead
+// code.
+#ifdef NOEVAL_NO_DEBUG
+#define NOEVAL_DEBUG_ENABLED(category) \
+    (static_cast<void>(debug_category::category), false)
+#else
+#define NOEVAL_DEBUG_ENABLED(category) \
+    get_debug().is_enabled(debug_category::category)
+#endif
 
-extern std::unordered_map<std::string, std::string> debug_categories;
+#define NOEVAL_DEBUG(category, ...) \
+    do { \
+        if (NOEVAL_DEBUG_ENABLED(category)) { \
+            get_debug().log(debug_category::category, __VA_ARGS__); \
+        } \
+    } while (false)
+
+// Each category is a bit in debug_controller's mask.
+enum class debug_category: std::uint32_t {
+    eval        = 1u << 0,
+    env_lookup  = 1u << 1,
+    env_binding = 1u << 2,
+    env_dump    = 1u << 3,
+    operative   = 1u << 4,
+    builtin     = 1u << 5,
+    parse       = 1u << 6,
+    library     = 1u << 7,
+    error       = 1u << 8,
+    stack_depth = 1u << 9,
+    gc          = 1u << 10,
+    tco         = 1u << 11,
+    timer       = 1u << 12,
+    gc_roots    = 1u << 13,
+};
+
+struct debug_category_info {
+    debug_category category;
+    std::string_view name;
+    std::string_view color;
+};
+
+// Currently, the only data here besides the name is the color.
+// But this also defines what choices there are.
+inline constexpr std::array debug_categories{
+    debug_category_info{debug_category::eval,        "eval",        "\033[36m"}, // Cyan
+    debug_category_info{debug_category::env_lookup,  "env_lookup",  "\033[32m"}, // Green
+    debug_category_info{debug_category::env_binding, "env_binding", "\033[33m"}, // Yellow
+    debug_category_info{debug_category::env_dump,    "env_dump",    "\033[35m"}, // Magenta
+    debug_category_info{debug_category::operative,   "operative",   "\033[34m"}, // Blue
+    debug_category_info{debug_category::builtin,     "builtin",     "\033[90m"}, // Dark gray
+    debug_category_info{debug_category::parse,       "parse",       "\033[31m"}, // Red
+    debug_category_info{debug_category::library,     "library",     "\033[95m"}, // Light magenta
+    debug_category_info{debug_category::error,       "error",       "\033[91m"}, // Light red
+    debug_category_info{debug_category::stack_depth, "stack-depth", "\033[0m"},  // Reset
+    debug_category_info{debug_category::gc,          "gc",          "\033[0m"},  // Reset
+    debug_category_info{debug_category::tco,         "tco",         "\033[0m"},  // Reset
+    debug_category_info{debug_category::timer,       "timer",       "\033[0m"},  // Reset
+    debug_category_info{debug_category::gc_roots,    "gc_roots",    "\033[0m"},  // Reset
+};
 
 class debug_controller {
 private:
-    std::unordered_set<std::string> enabled_categories;
+    std::uint32_t enabled_mask{0};
     bool use_colors = true;
-    
+
 public:
+    // These take the user-facing names. "all" and "none" are also accepted.
     void enable(const std::string& category);
     void disable(const std::string& category);
-    std::unordered_set<std::string> get_enabled_categories() const;
-    void set_enabled_categories(const std::unordered_set<std::string>& categories);
+    std::vector<std::string> get_enabled_categories() const;
     void enable_all();
     void disable_all();
-    bool is_enabled(const std::string& category) const;
+    bool is_enabled(debug_category category) const
+    { return 0 != (enabled_mask & std::to_underlying(category)); }
     void set_colors(bool enable);
     bool are_colors_enabled() const;
-    
+
     // Formatted debug output
+    // Callers should go through NOEVAL_DEBUG so that the arguments are not
+    // evaluated when the category is disabled.
     template<typename... Args>
-    void log(const std::string& category,
+    void log(debug_category category,
         const std::string& format_str, Args&&... args)
     {
-        if (!is_enabled(category)) return;
-        
+        if (not is_enabled(category)) return;
+
         std::string prefix = get_prefix(category);
         if (use_colors) {
-            prefix = get_color(category) + prefix + "\033[0m";
+            prefix = std::string{get_color(category)} + prefix + "\033[0m";
         }
-        
+
         // Use std::vformat instead of std::format with runtime format string
         std::string message = std::vformat(format_str, std::make_format_args(args...));
         std::println("{} {}", prefix, message);
     }
-    
+
 private:
-    std::string get_prefix(const std::string& category) const;
-    std::string get_color(const std::string& category) const;
+    static const debug_category_info& get_info(debug_category category);
+    std::string get_prefix(debug_category category) const;
+    std::string_view get_color(debug_category category) const;
 };
 
-debug_controller& get_debug();
+// Defined inline so that the is_enabled check on the hot path doesn't need a
+// call into another translation unit.
+inline debug_controller& get_debug()
+{
+    static debug_controller instance;
+    return instance;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <optional>
+#include <print>
+#include <vector>
+
+#include "gc_stats.hpp"
+
+namespace {
+    using std::chrono::nanoseconds;
+
+    struct file_closer {
+        void operator()(std::FILE* file) const { std::fclose(file); }
+    };
+
+    std::unique_ptr<std::FILE, file_closer> collection_file;
+    std::string collection_file_path;
+    record_format collection_file_format{record_format::json};
+
+    constexpr std::string_view csv_header{
+        "kind,trigger,start_us,mark_us,sweep_us,pause_us,registry,marked,swept,freed"};
+
+    double microseconds(nanoseconds time)
+    {
+        return std::chrono::duration<double, std::micro>{time}.count();
+    }
+
+    size_t pause_bucket(nanoseconds pause)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(pause).count();
+        size_t bucket{0};
+        while ((us > 0) and (bucket + 1 < pause_bucket_count)) {
+            us /= 2;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    time_summary summarize(std::vector<nanoseconds>& times)
+    {
+        time_summary summary;
+        summary.count = times.size();
+        if (times.empty()) return summary;
+        std::ranges::sort(times);
+        for (auto time: times) summary.total += time;
+        auto percentile = [&](size_t p) {
+            // The smallest time that at least p% of them are no more than
+            auto rank = (p * times.size() + 99) / 100;
+            return times[std::max<size_t>(rank, 1) - 1];
+        };
+        summary.p50 = percentile(50);
+        summary.p90 = percentile(90);
+        summary.p99 = percentile(99);
+        summary.max = times.back();
+        return summary;
+    }
+
+    collection_summary summarize(collection_kind kind)
+    {
+        collection_summary summary{.kind = kind};
+        std::vector<nanoseconds> pauses, marks, sweeps;
+        environment::get_collection_log().for_each([&](const collection_record& record) {
+            if (kind != record.kind) return;
+            pauses.push_back(record.pause());
+            marks.push_back(record.mark_time);
+            sweeps.push_back(record.sweep_time);
+            summary.marked += record.marked;
+            summary.freed += record.freed;
+            ++summary.histogram[pause_bucket(record.pause())];
+        });
+        summary.pause = summarize(pauses);
+        summary.mark = summarize(marks);
+        summary.sweep = summarize(sweeps);
+        return summary;
+    }
+}
+
+std::chrono::microseconds pause_bucket_floor(size_t bucket)
+{
+    return std::chrono::microseconds{(0 == bucket)? 0: 1 << (bucket - 1)};
+}
+
+gc_summary summarize_collections()
+{
+    const auto& log = environment::get_collection_log();
+    gc_summary summary;
+    summary.records = log.size();
+    summary.dropped = log.get_total() - log.size();
+    summary.minor = summarize(collection_kind::minor);
+    summary.major = summarize(collection_kind::major);
+
+    std::optional<nanoseconds> first;
+    log.for_each([&](const collection_record& record) {
+        if (not first) first = record.start;
+        summary.span = record.start + record.pause() - *first;
+        summary.collecting += record.pause();
+    });
+    return summary;
+}
+
+std::string_view to_string(collection_kind kind)
+{
+    switch (kind) {
+    case collection_kind::none: return "none";
+    case collection_kind::minor: return "minor";
+    case collection_kind::major: return "major";
+    }
+    return "unknown";
+}
+
+std::string_view to_string(collection_trigger trigger)
+{
+    switch (trigger) {
+    case collection_trigger::allocation: return "allocation";
+    case collection_trigger::growth: return "growth";
+    case collection_trigger::request: return "request";
+    }
+    return "unknown";
+}
+
+std::string format_collection_record(const collection_record& record, record_format format)
+{
+    if (record_format::csv == format) {
+        return std::format("{},{},{:.3f},{:.3f},{:.3f},{:.3f},{},{},{},{}",
+            to_string(record.kind), to_string(record.trigger), microseconds(record.start),
+            microseconds(record.mark_time), microseconds(record.sweep_time), microseconds(record.pause()),
+            record.registry_size, record.marked, record.swept, record.freed);
+    }
+    return std::format(
+        R"({{"kind":"{}","trigger":"{}","start_us":{:.3f},"mark_us":{:.3f},"sweep_us":{:.3f},)"
+        R"("pause_us":{:.3f},"registry":{},"marked":{},"swept":{},"freed":{}}})",
+        to_string(record.kind), to_string(record.trigger), microseconds(record.start),
+        microseconds(record.mark_time), microseconds(record.sweep_time), microseconds(record.pause()),
+        record.registry_size, record.marked, record.swept, record.freed);
+}
+
+bool open_collection_file(const std::string& path)
+{
+    std::unique_ptr<std::FILE, file_closer> file{std::fopen(path.c_str(), "w")};
+    if (not file) return false;
+    collection_file = std::move(file);
+    collection_file_path = path;
+    collection_file_format = path.ends_with(".csv")? record_format::csv: record_format::json;
+    if (record_format::csv == collection_file_format) {
+        std::println(collection_file.get(), "{}", csv_header);
+    }
+    return true;
+}
+
+void close_collection_file()
+{
+    collection_file.reset();
+    collection_file_path.clear();
+}
+
+const std::string& get_collection_file()
+{
+    return collection_file_path;
+}
+
+void log_collection(const collection_record& record)
+{
+    if (not collection_file) return;
+    std::println(collection_file.get(), "{}", format_collection_record(record, collection_file_format));
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "noeval.hpp"
+
+// Collection telemetry
+//
+// environment keeps a record of each of its recent collections (see
+// collection_log). This summarizes them for :gc stats and (gc-stats), so that
+// pauses can be compared across policy settings and changes to the
+// collector. It can also write each record to a file as it's made, for
+// looking at more collections than the log keeps.
+
+// Nearest-rank percentiles of some times
+struct time_summary {
+    size_t count{0};
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p90{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds max{0};
+};
+
+// Pauses are counted in buckets by powers of two microseconds: the first is
+// under 1 µs, bucket i is under 2^i µs, and the last is everything longer
+// than that.
+inline constexpr size_t pause_bucket_count{20};
+
+// The lower limit of a bucket
+std::chrono::microseconds pause_bucket_floor(size_t bucket);
+
+struct collection_summary {
+    collection_kind kind{collection_kind::none};
+    time_summary pause{};
+    time_summary mark{};
+    time_summary sweep{};
+    size_t marked{0};
+    size_t freed{0};
+    std::array<size_t, pause_bucket_count> histogram{};
+};
+
+struct gc_summary {
+    // The collections the log still has records for, and the ones it
+    // doesn't anymore
+    size_t records{0};
+    size_t dropped{0};
+    collection_summary minor{.kind = collection_kind::minor};
+    collection_summary major{.kind = collection_kind::major};
+    // The time from the start of the first collection in the log to the end
+    // of the last one, and how much of that was spent collecting
+    std::chrono::nanoseconds span{0};
+    std::chrono::nanoseconds collecting{0};
+
+    double collecting_fraction() const
+    {
+        return (0 == span.count())? 0: static_cast<double>(collecting.count()) / span.count();
+    }
+};
+
+gc_summary summarize_collections();
+
+std::string_view to_string(collection_kind kind);
+std::string_view to_string(collection_trigger trigger);
+
+// Starts writing a line for each collection to the file (replacing it). The
+// lines are CSV if the name ends with .csv, and JSON otherwise. Returns false
+// if the file can't be opened.
+bool open_collection_file(const std::string& path);
+void close_collection_file();
+// Where records are being written, or empty
+const std::string& get_collection_file();
+
+// Called by environment at the end of each collection
+void log_collection(const collection_record& record);
+
+enum class record_format {csv, json};
+std::string format_collection_record(const collection_record& record, record_format format);
@@ -0,0 +1,111 @@
+#include <array>
+#include <numeric>
+#include <unordered_set>
+
+#include "heap_stats.hpp"
+#include "noeval.hpp"
+
+namespace {
+    // In the order of value::data_type
+    constexpr std::array<std::string_view, value::type_count> value_type_names{
+        "number",
+        "string",
+        "symbol",
+        "cons-cell",
+        "operative",
+        "builtin-operative",
+        "environment",
+        "mutable-binding",
+        "eof-object",
+        "nil",
+    };
+
+    // Heap bytes of a string's characters, if they aren't stored inline
+    size_t string_bytes(const std::string& s)
+    {
+        static const size_t inline_capacity{std::string{}.capacity()};
+        return (s.capacity() > inline_capacity)? s.capacity() + 1: 0;
+    }
+
+    size_t bignum_bytes(const number& n)
+    {
+        namespace bmp = boost::multiprecision;
+        auto big = n.to_bignum();
+        auto limbs = bmp::numerator(big).backend().size() + bmp::denominator(big).backend().size();
+        return boxed<bignum>::node_size() + limbs * sizeof(bmp::limb_type);
+    }
+
+    // Finds every value that an environment refers to, directly or not, and
+    // adds up what they hold outside themselves.
+    void walk_heap(heap_report& report)
+    {
+        std::unordered_set<const value*> reached;
+        std::vector<const value*> pending;
+        auto reach = [&](const value_ptr& v) {
+            if (v and reached.insert(v.get()).second) pending.push_back(v.get());
+        };
+
+        environment::for_each_environment([&](const environment& env) {
+            ++report.environments.reached;
+            report.environments.payload_bytes += env.get_bindings().heap_bytes();
+            env.get_bindings().for_each([&](symbol_id, const value_ptr& v) { reach(v); });
+        });
+
+        while (not pending.empty()) {
+            const value* v = pending.back();
+            pending.pop_back();
+            auto& entry = report.values[v->data.index()];
+            ++entry.reached;
+            if (auto n = std::get_if<number>(&v->data)) {
+                if (not n->is_fixnum()) entry.payload_bytes += bignum_bytes(*n);
+            } else if (auto s = std::get_if<boxed<std::string>>(&v->data)) {
+                entry.payload_bytes += s->node_size() + string_bytes(**s);
+            } else if (auto cell = std::get_if<cons_cell>(&v->data)) {
+                reach(cell->car);
+                reach(cell->cdr);
+            } else if (auto op = std::get_if<boxed<operative>>(&v->data)) {
+                entry.payload_bytes += op->node_size() +
+                    string_bytes((*op)->env_param) + string_bytes((*op)->tag) +
+                    (*op)->params.param_names.capacity() * sizeof(std::string);
+                for (const auto& name: (*op)->params.param_names) {
+                    entry.payload_bytes += string_bytes(name);
+                }
+                reach((*op)->body);
+            } else if (auto builtin = std::get_if<boxed<builtin_operative>>(&v->data)) {
+                entry.payload_bytes += builtin->node_size() + string_bytes((*builtin)->name);
+            } else if (auto mb = std::get_if<mutable_binding>(&v->data)) {
+                reach(mb->value);
+            }
+        }
+    }
+}
+
+size_t heap_report::total_bytes() const
+{
+    auto add = [](size_t sum, const heap_entry& e) { return sum + e.bytes + e.payload_bytes; };
+    return std::accumulate(values.begin(), values.end(), add(0, environments), add);
+}
+
+heap_report get_heap_report(bool detailed)
+{
+    heap_report report;
+    report.detailed = detailed;
+    for (size_t i{0}; i < value::type_count; ++i) {
+        const auto& count = value::get_live_count(i);
+        report.values.push_back({
+            .type = value_type_names[i],
+            .live = count.live,
+            .peak = count.peak,
+            .bytes = count.live * sizeof(value),
+        });
+    }
+    report.environments = {
+        .type = "environment",
+        .live = environment::get_constructed_count(),
+        .peak = environment::get_peak_constructed_count(),
+        .bytes = environment::get_constructed_count() * sizeof(environment),
+    };
+    if (detailed) walk_heap(report);
+    report.pool = get_pool_stats();
+    return report;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "allocation.hpp"
+
+// Live heap accounting
+//
+// The number of live values of each type and of environments, and the most
+// there have been at once, are counted as objects are made and destroyed, so
+// they are always available. Their bytes are those counts times the size of
+// the objects.
+//
+// A detailed report also walks every environment and the values
+// they refer to, and adds up what those objects hold outside themselves:
+// boxed payloads, string and bignum storage, and big binding tables. That's
+// about as much work as a collection, so it's only done when asked for.
+// Values that are live but weren't reached are held only by the C++ code
+// (like the constant pool) or leaked.
+struct heap_entry {
+    // The name typeof uses, except that builtin operatives are separate
+    std::string_view type;
+    size_t live{0};
+    size_t peak{0};
+    size_t bytes{0};
+    // Only filled in by a detailed report
+    size_t reached{0};
+    size_t payload_bytes{0};
+};
+
+struct heap_report {
+    bool detailed{false};
+    // One for each value type
+    std::vector<heap_entry> values;
+    heap_entry environments;
+    pool_stats pool;
+
+    // Bytes of the values and environments themselves (plus payloads, when
+    // detailed)
+    size_t total_bytes() const;
+};
+
+heap_report get_heap_report(bool detailed = false);
@@ -4,19 +4,29 @@
 // NOTE THAT nil IS SPELT ()
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
+#include <deque>
 #include <format>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <print>
 #include <ranges>
 #include <string_view>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
 #include "debug.hpp"
+#include "gc_stats.hpp"
+#include "heap_stats.hpp"
 #include "noeval.hpp"
 #include "parser.hpp"
 #include "repl.hpp"
@@ -101,9 +111,10 @@ std::string to_decimal_string(const bignum& value)
 }
 
 
-std::string to_string(const bignum& value)
+std::string to_string(const number& value)
 {
-    return to_decimal_string(value);
+    if (value.is_fixnum()) return std::to_string(value.get_fixnum());
+    return to_decimal_string(value.to_bignum());
 }
 
 std::string to_string(const std::string& value)
@@ -169,7 +180,12 @@ std::string value_to_string(const continuation_type& k)
 std::string value_type_string(const value_ptr& val)
 {
     return std::visit([](const auto& v) -> std::string {
-        return demangle<decltype(v)>();
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (is_boxed_v<T>) {
+            return demangle<typename T::element_type>();
+        } else {
+            return demangle<T>();
+        }
     }, val->data);
 }
 
@@ -201,18 +217,169 @@ bool cons_cell::operator==(const cons_cell& that) const
     return *car == *(that.car) and *cdr == *(that.cdr);
 }
 
+namespace {
+
+struct symbol_table {
+    // A deque so that the views in ids stay valid as names are added
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, symbol_id> ids;
+};
+
+symbol_table& get_symbol_table()
+{
+    static symbol_table table;
+    return table;
+}
+
+} // namespace
+
+symbol_id intern_symbol(std::string_view name)
+{
+    auto& table = get_symbol_table();
+    if (auto it = table.ids.find(name); it != table.ids.end()) return it->second;
+    auto id = static_cast<symbol_id>(table.names.size());
+    const auto& stored = table.names.emplace_back(name);
+    table.ids.emplace(stored, id);
+    return id;
+}
+
+const std::string& symbol_name(symbol_id id)
+{
+    return get_symbol_table().names[id];
+}
+
+const lexical_scope* lexical_scope::intern(std::vector<symbol_id> names,
+    const lexical_scope* parent)
+{
+    // Scopes are never freed. There is one per distinct parameter list and
+    // enclosing scope, which is bounded by the code, not by how often it runs.
+    static std::map<std::pair<const lexical_scope*, std::vector<symbol_id>>,
+        std::unique_ptr<lexical_scope>> scopes;
+    auto& scope = scopes[{parent, names}];
+    if (not scope) {
+        scope = std::make_unique<lexical_scope>(std::move(names), parent);
+    }
+    return scope.get();
+}
+
+std::ptrdiff_t lexical_scope::find(symbol_id name) const
+{
+    for (auto i = std::ssize(names) - 1; i >= 0; --i) {
+        if (name == names[i]) return i;
+    }
+    return -1;
+}
+
+namespace {
+
+// Collects the names the body defines with a literal (define name ...).
+// Nested operatives are included too, which is conservative.
+void collect_defined_names(const value* expr, std::unordered_set<symbol_id>& names)
+{
+    static const symbol define_symbol{"define"};
+    while (auto cell = std::get_if<cons_cell>(&expr->data)) {
+        auto head = std::get_if<symbol>(&cell->car->data);
+        auto rest = std::get_if<cons_cell>(&cell->cdr->data);
+        if (head and rest and (define_symbol == *head)) {
+            if (auto name = std::get_if<symbol>(&rest->car->data)) {
+                names.insert(name->id);
+            }
+        }
+        collect_defined_names(cell->car.get(), names);
+        expr = cell->cdr.get();
+    }
+}
+
+void assign_lexical_address(const symbol& sym, const lexical_scope* scope,
+    const std::unordered_set<symbol_id>& defined)
+{
+    std::uint32_t depth{0};
+    for (auto frame = scope; frame; frame = frame->parent, ++depth) {
+        auto slot = frame->find(sym.id);
+        if (slot < 0) continue;
+        // A define in the body would bind the name in the operative's own
+        // frame, shadowing any enclosing frame. (A define of a parameter just
+        // replaces the slot's value, so those are fine.)
+        if ((0 < depth) and defined.contains(sym.id)) return;
+        // Addresses are kept small. Anything deeper just gets looked up.
+        constexpr std::uint32_t limit{std::numeric_limits<std::uint16_t>::max()};
+        if ((depth > limit) or (static_cast<std::uint32_t>(slot) > limit)) return;
+        sym.address = {scope, static_cast<std::uint16_t>(depth), static_cast<std::uint16_t>(slot)};
+        return;
+    }
+}
+
+void assign_lexical_addresses(const value* expr, const lexical_scope* scope,
+    const std::unordered_set<symbol_id>& defined)
+{
+    while (auto cell = std::get_if<cons_cell>(&expr->data)) {
+        assign_lexical_addresses(cell->car.get(), scope, defined);
+        expr = cell->cdr.get();
+    }
+    if (auto sym = std::get_if<symbol>(&expr->data)) {
+        assign_lexical_address(*sym, scope, defined);
+    }
+}
+
+} // namespace
+
+// The analysis pass for lexical addressing. Every symbol in the body that
+// names a parameter of this operative or of the operatives whose frames it is
+// nested in gets the address of that parameter's slot.
+//
+// This is done for every symbol, not just those in positions that will be
+// evaluated, since in a fexpr language there is no telling which those are.
+// That is safe because an address is only used when the symbol is evaluated
+// in a frame of the scope it was computed for. Names the body defines are
+// left to be looked up by name. That also isn't enough on its own since an
+// operative can define anything in its caller's environment, so
+// environment::lookup_address also checks the frames it skips over.
+void assign_lexical_addresses(const value_ptr& body, const lexical_scope* scope)
+{
+    std::unordered_set<symbol_id> defined;
+    collect_defined_names(body.get(), defined);
+    assign_lexical_addresses(body.get(), scope, defined);
+}
+
+operative::operative(param_pattern p, std::string e, value_ptr b,
+    env_root_ptr env, std::string_view t)
+    : params(std::move(p)), env_param(std::move(e)),
+      body(std::move(b)), closure_env(std::move(env.get())), tag(t)
+{
+    auto names = params.param_names
+        | std::views::transform(intern_symbol)
+        | std::ranges::to<std::vector>();
+    if (not env_param.empty()) names.push_back(intern_symbol(env_param));
+    scope = lexical_scope::intern(std::move(names), closure_env->get_scope());
+    assign_lexical_addresses(body, scope);
+}
+
+// Wrapped combiners print as the expression that would wrap them.
+std::string wrap_string(std::string unwrapped, size_t wrap_count)
+{
+    for (; wrap_count > 0; --wrap_count) {
+        unwrapped = "(wrap " + unwrapped + ")";
+    }
+    return unwrapped;
+}
+
 std::string operative::to_string() const
 {
-    if (not tag.empty()) return tag;
+    if (not tag.empty()) return wrap_string(tag, wrap_count);
     // It isn't easy (yet) to change the delimiter that format uses for ranges,
     // so explicitly use std::views::join_with.
-    return std::format("(operative {}{:s}{} {} {})",
+    return wrap_string(std::format("(operative {}{:s}{} {} {})",
         params.is_variadic? "": "(",
         params.param_names | std::views::join_with(' '),
         params.is_variadic? "": ")",
         env_param,
         value_to_string(body)
-    );
+    ), wrap_count);
+}
+
+std::string builtin_operative::to_string() const
+{
+    return wrap_string("#<builtin-operative:" + name + ">", wrap_count);
 }
 
 std::string mutable_binding::to_string() const
@@ -238,11 +405,119 @@ value_ptr unwrap_mutable_binding(value_ptr value)
     return value;
 }
 
+namespace {
+    // For ref_ptr_delete
+    std::vector<value_ptr> pending_cells;
+    bool releasing_cells{false};
+
+    // Takes a cell's car and cdr, if they're cells that we hold the last
+    // references to
+    void take_cells(value* v)
+    {
+        auto cell = std::get_if<cons_cell>(&v->data);
+        if (not cell) return;
+        for (auto child: {&cell->car, &cell->cdr}) {
+            if (*child and (1 == child->use_count()) and std::holds_alternative<cons_cell>((*child)->data)) {
+                pending_cells.push_back(std::move(*child));
+            }
+        }
+    }
+}
+
+// Destroying a list would otherwise recurse once per cell, and a long (or
+// deeply nested) enough list would overflow the stack. Instead, take the
+// cells a cell refers to before it is destroyed, and destroy those here.
+// Destroying them calls this again, which just adds to the pending cells.
+void ref_ptr_delete(value* v)
+{
+    take_cells(v);
+    delete v;
+    if (releasing_cells) return;
+    releasing_cells = true;
+    while (not pending_cells.empty()) {
+        auto next = std::move(pending_cells.back());
+        pending_cells.pop_back();
+        take_cells(next.get());
+    }
+    releasing_cells = false;
+}
+
+value_ptr constant_pool::nil()
+{
+    static const value_ptr instance{value::make(nullptr)};
+    ++hits;
+    return instance;
+}
+
+value_ptr constant_pool::eof()
+{
+    static const value_ptr instance{value::make(eof_object{})};
+    ++hits;
+    return instance;
+}
+
+value_ptr constant_pool::make_number(number n)
+{
+    constexpr auto count{static_cast<size_t>(small_integer_max - small_integer_min + 1)};
+    static std::array<value_ptr, count> small_integers;
+    if (n.is_fixnum() and
+        (n.get_fixnum() >= small_integer_min) and
+        (n.get_fixnum() <= small_integer_max))
+    {
+        auto& shared = small_integers[n.get_fixnum() - small_integer_min];
+        if (shared) {
+            ++hits;
+        } else {
+            ++misses;
+            shared = value::make(std::move(n));
+        }
+        return shared;
+    }
+    ++misses;
+    return value::make(std::move(n));
+}
+
+namespace {
+    std::unordered_map<std::string, value_ptr>& literal_table()
+    {
+        static std::unordered_map<std::string, value_ptr> literals;
+        return literals;
+    }
+}
+
+value_ptr constant_pool::make_literal(const std::string& s)
+{
+    auto& literals = literal_table();
+    if (s.size() > literal_length_max) {
+        ++misses;
+        return value::make(s);
+    }
+    if ((literals.size() >= literal_count_max) and not literals.contains(s)) {
+        // Forget the ones nothing else is using. If most are still in use,
+        // forget them all rather than doing this again on the next miss.
+        std::erase_if(literals, [](const auto& entry) { return 1 == entry.second.use_count(); });
+        if (literals.size() > literal_count_max / 2) literals.clear();
+    }
+    auto [iter, inserted] = literals.try_emplace(s);
+    if (inserted) {
+        ++misses;
+        iter->second = value::make(s);
+    } else {
+        ++hits;
+    }
+    return iter->second;
+}
+
+size_t constant_pool::get_literal_count()
+{
+    return literal_table().size();
+}
+
 // Should be const references...
 bool operator==(value& lhs, value& rhs)
 {
-    value_ptr lhs_ptr = lhs.shared_from_this();
-    value_ptr rhs_ptr = rhs.shared_from_this();
+    value_ptr lhs_ptr{&lhs};
+    value_ptr rhs_ptr{&rhs};
     value_ptr lhs_unwrapped = unwrap_mutable_binding(lhs_ptr);
     value_ptr rhs_unwrapped = unwrap_mutable_binding(rhs_ptr);
 
@@ -268,42 +543,154 @@ std::string typeof_visitor::operator()(const mutable_binding& mb) const
 }
 
 // Environment implementation
-value_ptr environment::lookup(const std::string& name) const
+value_ptr* binding_table::find(symbol_id name)
+{
+    if (index) {
+        auto it = index->find(name);
+        return (it != index->end())? &at(it->second): nullptr;
+    }
+    for (auto i = std::ssize(overflow) - 1; i >= 0; --i) {
+        if (name == overflow[i].first) return &overflow[i].second;
+    }
+    for (auto i = std::min<size_t>(count, inline_capacity); i > 0; --i) {
+        if (name == inline_names[i - 1]) return &inline_values[i - 1];
+    }
+    return nullptr;
+}
+
+const value_ptr* binding_table::find(symbol_id name) const
+{
+    return const_cast<binding_table*>(this)->find(name);
+}
+
+void binding_table::append(symbol_id name, value_ptr val)
+{
+    if (count < inline_capacity) {
+        inline_names[count] = name;
+        inline_values[count] = std::move(val);
+    } else {
+        overflow.emplace_back(name, std::move(val));
+    }
+    if (index) {
+        (*index)[name] = count;
+    } else if (count + 1 > index_threshold) {
+        // Built in order so later bindings of a name win
+        index = std::make_unique<std::unordered_map<symbol_id, size_t>>();
+        size_t position{0};
+        for_each([&](symbol_id bound, const value_ptr&) {
+            (*index)[bound] = position++;
+        });
+    }
+    ++count;
+}
+
+void binding_table::clear()
+{
+    std::ranges::fill(inline_values, nullptr);
+    overflow.clear();
+    index.reset();
+    count = 0;
+}
+
+size_t binding_table::heap_bytes() const
+{
+    size_t bytes = overflow.capacity() * sizeof(overflow.front());
+    if (index) {
+        // A node per entry (with its hash) and a bucket array
+        using node = std::pair<symbol_id, size_t>;
+        bytes += sizeof(*index) +
+            index->size() * (sizeof(node) + 2 * sizeof(void*)) +
+            index->bucket_count() * sizeof(void*);
+    }
+    return bytes;
+}
+
+value_ptr environment::lookup(symbol_id name) const
 {
-    NOEVAL_DEBUG(env_lookup, "Looking up '{}' in env {}", name, static_cast<const void*>(this));
+    NOEVAL_DEBUG(env_lookup, "Looking up '{}' in env {}", symbol_name(name), static_cast<const void*>(this));
     
     if (NOEVAL_DEBUG_ENABLED(env_dump)) {
         NOEVAL_DEBUG(env_dump, "Current bindings:");
-        for (const auto& [key, value] : bindings) {
-            NOEVAL_DEBUG(env_dump, "  {} -> {}", key, value_to_string(value));
-        }
+        bindings.for_each([](symbol_id key, const value_ptr& value) {
+            NOEVAL_DEBUG(env_dump, "  {} -> {}", symbol_name(key), value_to_string(value));
+        });
         if (parent) {
             NOEVAL_DEBUG(env_dump, "Parent env: {}", static_cast<const void*>(parent.get()));
         }
     }
 
-    auto it = bindings.find(name);
-    if (it != bindings.end()) {
-        NOEVAL_DEBUG(env_lookup, "Found '{}' in current environment", name);
-        return it->second;
+    if (auto binding = bindings.find(name)) {
+        NOEVAL_DEBUG(env_lookup, "Found '{}' in current environment", symbol_name(name));
+        return *binding;
     }
     if (parent) {
         NOEVAL_DEBUG(env_lookup, "Not found, checking parent...");
         return parent->lookup(name);
     }
-    throw std::runtime_error("Unbound variable: " + name);
+    throw std::runtime_error("Unbound variable: " + symbol_name(name));
 }
 
-void environment::define(const std::string& name, value_ptr val)
+void environment::define(symbol_id name, value_ptr val)
 {
     NOEVAL_DEBUG(env_binding, "Binding '{}' in env {} to {}", 
-              name, static_cast<const void*>(this), value_to_string(val));
-    bindings[name] = std::move(val);
+              symbol_name(name), static_cast<const void*>(this), value_to_string(val));
+    if (cached_through) ++generation;
+    note_write();
+    if (auto binding = bindings.find(name)) {
+        *binding = std::move(val);
+    } else {
+        bindings.append(name, std::move(val));
+    }
+}
+
+value* environment::find_local(symbol_id name) const
+{
+    auto binding = bindings.find(name);
+    return binding? binding->get(): nullptr;
+}
+
+value* environment::lookup_for_cache(symbol_id name)
+{
+    for (environment* env = this; env; env = env->parent.get()) {
+        env->cached_through = true;
+        if (auto binding = env->find_local(name)) return binding;
+    }
+    return nullptr;
+}
+
+void environment::bind_slot(size_t slot, value_ptr val)
+{
+    NOEVAL_DEBUG(env_binding, "Binding parameter '{}' in env {} to {}", 
+              symbol_name(scope->names[slot]), static_cast<const void*>(this), value_to_string(val));
+    // Evaluating the operands could have collected since this was made.
+    note_write();
+    bindings.at(slot) = std::move(val);
+}
+
+const value_ptr* environment::lookup_address(const symbol& sym) const
+{
+    const auto& address = sym.address;
+    if ((nullptr == scope) or (address.scope != scope)) return nullptr;
+    const environment* frame = this;
+    for (auto depth = address.depth; depth > 0; --depth) {
+        // The scopes guarantee that none of the frames skipped over have a
+        // parameter with this name, but something might have defined it.
+        if ((frame->bindings.size() > frame->scope->names.size()) and
+            frame->bindings.find(sym.id))
+        {
+            return nullptr;
+        }
+        frame = frame->parent.get();
+    }
+    return &frame->bindings.at(address.slot);
 }
 
 std::vector<std::string> environment::get_all_symbols() const
 {
-    auto symbols = bindings | std::views::keys | std::ranges::to<std::vector>();
+    std::vector<std::string> symbols;
+    bindings.for_each([&](symbol_id name, const value_ptr&) {
+        symbols.push_back(symbol_name(name));
+    });
     if (parent) {
         std::ranges::copy(parent->get_all_symbols(), std::back_inserter(symbols));
     }
@@ -313,11 +700,10 @@ std::vector<std::string> environment::get_all_symbols() const
 std::vector<std::string> environment::get_root_symbols()
 {
     std::vector<std::string> symbols;
-    for (const auto& [env_weak, count]: roots) {
-        if (auto env = env_weak.lock(); env) {
-            std::ranges::copy(env->get_all_symbols(), std::back_inserter(symbols));
-        }
-    }
+    for_each_environment([&](const environment& env) {
+        if (0 == env.root_count) return;
+        std::ranges::copy(env.get_all_symbols(), std::back_inserter(symbols));
+    });
     return symbols;
 }
 
@@ -375,10 +761,20 @@ std::vector<value_ptr> list_to_vector(value_ptr list)
     return result;
 }
 
+// The reverse of list_to_vector
+value_ptr vector_to_list(const std::vector<value_ptr>& elements)
+{
+    value_ptr result = constant_pool::nil();
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+        result = value::make(cons_cell{*it, result});
+    }
+    return result;
+}
+
 // Helper to construct a Noeval list from C++ values
 value_ptr make_list(std::initializer_list<value_ptr> elements)
 {
-    value_ptr result = value::make(nullptr); // Start with nil
+    value_ptr result = constant_pool::nil(); // Start with nil
     
     // Build list backwards
     for (auto it = elements.end(); it != elements.begin(); ) {
@@ -402,7 +798,7 @@ param_pattern extract_param_pattern(value_ptr params)
 {
     // Handle single symbol case: (vau args env ...)
     if (std::holds_alternative<symbol>(params->data)) {
-        return {true, {std::get<symbol>(params->data).name}};
+        return {true, {std::get<symbol>(params->data).name()}};
     }
 
     // Handle list cases: (vau (a b . rest) env ...) or (vau (a b) env ...)
@@ -414,7 +810,7 @@ param_pattern extract_param_pattern(value_ptr params)
         if (!std::holds_alternative<symbol>(param->data)) {
             throw std::runtime_error("Parameter must be a symbol");
         }
-        fixed.push_back(std::get<symbol>(param->data).name);
+        fixed.push_back(std::get<symbol>(param->data).name());
         current = cdr(current);
     }
     
@@ -427,19 +823,26 @@ param_pattern extract_param_pattern(value_ptr params)
 }
 
 // Forward declarations:
-continuation_type operate_operative(const operative& op, value_ptr operands, env_root_ptr env);
-continuation_type operate_builtin(const builtin_operative& op, value_ptr operands, env_root_ptr env);
+continuation_type operate_operative(const operative& op, const value_ptr& operands, const env_root_ptr& env);
+continuation_type operate_builtin(const builtin_operative& op, const value_ptr& operands, const env_root_ptr& env);
 
 struct call_stack {
 private:
+    // A frame holds on to the expression being evaluated. It is only turned
+    // into a string if a stack trace is actually requested, since that is
+    // only needed when an error is being built.
+    struct frame {
+        value_ptr expr;
+    };
+
     // These were thread_local, but we aren't using threads (yet).
-    inline static std::vector<std::string> stack;
+    inline static std::vector<frame> stack;
     inline static size_t max_depth{0};
 public:
     struct guard {
         guard(value_ptr expr)
         {
-            stack.push_back(value_to_string(expr));
+            stack.push_back(frame{std::move(expr)});
             if (depth() > max_depth) max_depth = depth();
         }
         ~guard()
@@ -453,8 +856,8 @@ public:
     static std::string format()
     {
         std::string result;
-        for (const auto& [index, line] : stack | std::views::enumerate) {
-            result += std::format("{}: {}\n", index, line);
+        for (const auto& [index, f] : stack | std::views::enumerate) {
+            result += std::format("{}: {}\n", index, expr_context(f.expr));
         }
         return result;
     }
@@ -469,22 +872,22 @@ public:
 void   call_stack_reset_max_depth() { call_stack::reset_max_depth(); }
 size_t call_stack_get_max_depth()   { return call_stack::get_max_depth(); }
 
+// Builds an error context string that looks like the call: (name args...)
+std::string build_call_context(std::string_view name, operand_span args)
+{
+    std::string context = "(" + std::string{name};
+    for (const auto& arg : args) {
+        context += " " + expr_context(arg);
+    }
+    context += ")";
+    return context;
+}
+
 // Built-in operatives
 namespace builtins {
 
-    continuation_type vau_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type vau_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 3) {
-            throw evaluation_error(
-                std::format("vau: expected 3 arguments (params env-param body), got {}", args.size()),
-                std::format("(vau {} {} {})", 
-                    args.size() > 0 ? expr_context(args[0]) : "?",
-                    args.size() > 1 ? expr_context(args[1]) : "?",
-                    args.size() > 2 ? expr_context(args[2]) : "?"),
-                call_stack::format()
-            );
-        }
-        
         auto params_expr = args[0];
         auto env_param_expr = args[1];
         auto body_expr = args[2];
@@ -506,7 +909,7 @@ namespace builtins {
                         call_stack::format()
                     );
                 }
-                env_param_name = std::get<symbol>(env_param_expr->data).name;
+                env_param_name = std::get<symbol>(env_param_expr->data).name();
             }
             
             // Create the operative
@@ -529,21 +932,8 @@ namespace builtins {
     }
 
     // Helper function to validate eval arguments
-    void validate_eval_arguments(const std::vector<value_ptr>& args)
-    {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("eval: expected 2 arguments (expr env), got {}", args.size()),
-                args.empty() ? "(eval)" : 
-                args.size() == 1 ? std::format("(eval {})", expr_context(args[0])) :
-                std::format("(eval {} {} ...)", expr_context(args[0]), expr_context(args[1])),
-                call_stack::format()
-            );
-        }
-    }
-
     // Helper function to evaluate both arguments in current environment
-    std::pair<value_ptr, value_ptr> evaluate_eval_arguments(const std::vector<value_ptr>& args, env_root_ptr env)
+    std::pair<value_ptr, value_ptr> evaluate_eval_arguments(operand_span args, const env_root_ptr& env)
     {
         auto expr = args[0];          // Expression to evaluate (unevaluated)
         auto env_expr = args[1];      // Environment expression (unevaluated)
@@ -555,6 +945,8 @@ namespace builtins {
         // STAGE 1: Evaluate BOTH arguments in the CURRENT environment
         auto evaluated_expr = eval(expr, env);  // This is the key change!
         NOEVAL_DEBUG(operative, "First argument evaluated to: {}", value_to_string(evaluated_expr));
+        value_root_scope roots;
+        roots.add(evaluated_expr);
 
         auto env_val = eval(env_expr, env);
         NOEVAL_DEBUG(operative, "Environment expression evaluated to: {}", value_to_string(env_val));
@@ -563,7 +955,7 @@ namespace builtins {
     }
 
     // Helper function to extract environment from evaluated value
-    env_root_ptr extract_target_environment(value_ptr env_val, const std::vector<value_ptr>& args)
+    env_root_ptr extract_target_environment(value_ptr env_val, operand_span args)
     {
         if (!std::holds_alternative<env_ptr>(env_val->data)) {
             throw evaluation_error(
@@ -582,11 +974,9 @@ namespace builtins {
 
     // Evaluates both arguments, then evaluates the result of evaluating the
     // first argument in the environment evaluated from the second argument.
-    continuation_type eval_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type eval_operative(operand_span args, const env_root_ptr& env)
     {
         try {
-            validate_eval_arguments(args);
-            
             auto [evaluated_expr, env_val] = evaluate_eval_arguments(args, env);
             
             auto target_env = extract_target_environment(env_val, args);
@@ -609,19 +999,54 @@ namespace builtins {
         }
     }
 
+    // Calls f with a copy of the combiner the argument evaluates to, and
+    // returns the copy. Only operatives and builtins have a wrap_count.
+    value_ptr rewrap(std::string_view name, operand_span args, const env_root_ptr& env, auto&& f)
+    {
+        auto combiner = eval(args[0], env);
+        return std::visit([&](const auto& v) -> value_ptr {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, boxed<operative>> or std::is_same_v<T, boxed<builtin_operative>>) {
+                auto copy = v.get();
+                f(copy.wrap_count);
+                return value::make(std::move(copy));
+            } else {
+                throw evaluation_error(
+                    std::format("{} can only be applied to operatives, got {}",
+                        name, value_type_string(combiner)),
+                    build_call_context(name, args),
+                    call_stack::format()
+                );
+            }
+        }, combiner->data);
+    }
+
+    // Evaluates its argument, which must be an operative, and returns an
+    // operative that evaluates its operands before passing them on to it.
+    // The library's reference-wrap is the equivalent written in Noeval.
+    continuation_type wrap_operative(operand_span args, const env_root_ptr& env)
+    {
+        return rewrap("wrap", args, env, [](size_t& wrap_count) { ++wrap_count; });
+    }
+
+    // The inverse of wrap
+    continuation_type unwrap_operative(operand_span args, const env_root_ptr& env)
+    {
+        return rewrap("unwrap", args, env, [&](size_t& wrap_count) {
+            if (0 == wrap_count) {
+                throw evaluation_error(
+                    "unwrap: operative is not wrapped",
+                    build_call_context("unwrap", args),
+                    call_stack::format()
+                );
+            }
+            --wrap_count;
+        });
+    }
+
     // Does not evaluate first argument, but evaluates the second
-    continuation_type define_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type define_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("define: expected 2 arguments (symbol value), got {}", args.size()),
-                args.empty() ? "(define)" :
-                args.size() == 1 ? std::format("(define {})", expr_context(args[0])) :
-                std::format("(define {} {} ...)", expr_context(args[0]), expr_context(args[1])),
-                call_stack::format()
-            );
-        }
-        
         auto sym_expr = args[0];
         auto val_expr = args[1];
         
@@ -634,10 +1059,10 @@ namespace builtins {
         }
         
         try {
-            auto sym_name = std::get<symbol>(sym_expr->data).name;
+            auto name = std::get<symbol>(sym_expr->data).id;
             auto val = eval(val_expr, env);
             
-            env->define(sym_name, val);
+            env->define(name, val);
             return val;
         } catch (const evaluation_error&) {
             throw; // Re-throw evaluation errors as-is
@@ -651,9 +1076,9 @@ namespace builtins {
     }
 
     // Helper function to validate and extract number from value
-    bignum extract_number(const value_ptr& val, const std::string& op_name, const value_ptr& original_arg)
+    const number& extract_number(const value_ptr& val, const std::string& op_name, const value_ptr& original_arg)
     {
-        if (!std::holds_alternative<bignum>(val->data)) {
+        if (!std::holds_alternative<number>(val->data)) {
             throw evaluation_error(
                 std::format("{}: argument must be a number, got {}", 
                            op_name, value_to_string(val)),
@@ -661,14 +1086,14 @@ namespace builtins {
                 call_stack::format()
             );
         }
-        return std::get<bignum>(val->data);
+        return std::get<number>(val->data);
     }
 
     // Helper function to evaluate and validate the first argument
-    bignum evaluate_first_argument(const value_ptr& first_arg, const std::string& op_name, env_root_ptr env)
+    number evaluate_first_argument(const value_ptr& first_arg, const std::string& op_name, const env_root_ptr& env)
     {
         auto first_val = eval(first_arg, env);
-        if (!std::holds_alternative<bignum>(first_val->data)) {
+        if (!std::holds_alternative<number>(first_val->data)) {
             throw evaluation_error(
                 std::format("{}: argument must be a number, got {}", 
                            op_name, value_to_string(first_val)),
@@ -676,101 +1101,80 @@ namespace builtins {
                 call_stack::format()
             );
         }
-        return std::get<bignum>(first_val->data);
+        return std::get<number>(first_val->data);
     }
 
-    // Helper function to build error context for arithmetic operations
-    std::string build_arithmetic_context(const std::string& op_name, const std::vector<value_ptr>& args)
+    // The arithmetic operatives are instantiated from this template, with Op
+    // providing the name and the operation.
+    template<typename Op>
+    continuation_type arithmetic_operative(operand_span args, const env_root_ptr& env)
     {
-        std::string context = "(" + op_name;
-        for (const auto& arg : args) {
-            context += " " + expr_context(arg);
+        const std::string op_name{Op::name};
+        try {
+            number initial_value = evaluate_first_argument(args[0], op_name, env);
+
+            number result = std::ranges::fold_left(args | std::views::drop(1),
+                initial_value,
+                [&op_name, &env](number accumulator, const value_ptr& arg)
+                {
+                    auto val = eval(arg, env);
+                    const number& operand = extract_number(val, op_name, arg);
+                    return Op{}(accumulator, operand);
+                });
+                
+            return constant_pool::make_number(std::move(result));
+        } catch (const evaluation_error&) {
+            throw; // Re-throw evaluation errors as-is
+        } catch (const std::exception& e) {
+            throw evaluation_error(
+                std::format("{}: {}", op_name, e.what()),
+                build_call_context(op_name, args),
+                call_stack::format()
+            );
         }
-        context += ")";
-        return context;
     }
 
-    auto make_arithmetic_operative(const std::string& op_name, std::function<bignum(bignum, bignum)> op)
-    {
-        return [op_name, op](const std::vector<value_ptr>& args, env_root_ptr env) {
-            if (args.empty()) {
-                throw evaluation_error(
-                    std::format("{}: requires at least one argument", op_name),
-                    std::format("({})", op_name),
-                    call_stack::format()
-                );
-            }
-            
-            try {
-                bignum initial_value = evaluate_first_argument(args[0], op_name, env);
-
-                bignum result = std::ranges::fold_left(args | std::views::drop(1),
-                    initial_value,
-                    [op, op_name, &env](bignum accumulator, const value_ptr& arg)
-                    {
-                        auto val = eval(arg, env);
-                        bignum operand = extract_number(val, op_name, arg);
-                        return op(accumulator, operand);
-                    });
-                    
-                return value::make(result);
-            } catch (const evaluation_error&) {
-                throw; // Re-throw evaluation errors as-is
-            } catch (const std::exception& e) {
-                throw evaluation_error(
-                    std::format("{}: {}", op_name, e.what()),
-                    build_arithmetic_context(op_name, args),
-                    call_stack::format()
-                );
-            }
-        };
-    }
+    struct add_op {
+        static constexpr std::string_view name{"+"};
+        number operator()(const number& a, const number& b) const { return a + b; }
+    };
+
+    struct subtract_op {
+        static constexpr std::string_view name{"-"};
+        number operator()(const number& a, const number& b) const { return a - b; }
+    };
+
+    struct multiply_op {
+        static constexpr std::string_view name{"*"};
+        number operator()(const number& a, const number& b) const { return a * b; }
+    };
+
+    struct divide_op {
+        static constexpr std::string_view name{"/"};
+        number operator()(const number& a, const number& b) const { return a / b; }
+    };
 
     // Evaluates both arguments
-    continuation_type cons_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type cons_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("cons: expected 2 arguments (first rest), got {}", args.size()),
-                args.empty() ? "(cons)" : 
-                args.size() == 1 ? std::format("(cons {})", expr_context(args[0])) :
-                std::format("(cons {} {} ...)", expr_context(args[0]), expr_context(args[1])),
-                call_stack::format()
-            );
-        }
-        
         auto first_val = eval(args[0], env);
+        value_root_scope roots;
+        roots.add(first_val);
         auto rest_val = eval(args[1], env);
         
         return value::make(cons_cell{first_val, rest_val});
     }
 
     // Evaluates argument
-    continuation_type first_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type first_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("first: expected 1 argument, got {}", args.size()),
-                args.empty() ? "(first)" : std::format("(first {} ...)", expr_context(args[0])),
-                call_stack::format()
-            );
-        }
-        
         auto val = eval(args[0], env);
         return car(val);  // Uses existing helper
     }
 
     // Evaluates argument
-    continuation_type rest_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type rest_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("rest: expected 1 argument, got {}", args.size()),
-                args.empty() ? "(rest)" : std::format("(rest {} ...)", expr_context(args[0])),
-                call_stack::format()
-            );
-        }
-        
         auto val = eval(args[0], env);
         return cdr(val);  // Uses existing helper
     }
@@ -784,50 +1188,54 @@ namespace builtins {
                 value::make(symbol{symbol_name}),
                 value::make(cons_cell{
                     value::make(symbol{"env"}),
-                    value::make(nullptr)  // nil
+                    constant_pool::nil()  // nil
                 })
             })
         });
     }
 
-    auto church_true(env_root_ptr env)
-    {
-        //Lookup true in the given environment.
-        return env->lookup("true");
-    }
+    // The Church booleans are created once and shared by every top-level
+    // environment, so builtins can return them without looking them up and
+    // eval_operation can recognize them. Their bodies only need eval, so they
+    // close over an environment with just that. It is kept as a root so it is
+    // never collected.
+    struct church_booleans {
+        env_root_ptr env;
+        value_ptr true_value;
+        value_ptr false_value;
+    };
 
-    auto church_false(env_root_ptr env)
+    const church_booleans& get_church_booleans()
     {
-        //Lookup false in the given environment.
-        return env->lookup("false");
-    }
+        static const church_booleans booleans = [] {
+            auto env = environment::make();
+            env->define("eval", value::make(builtin_operative{"eval", eval_operative, 2, 2}));
+            auto make_boolean = [&](std::string_view selected, std::string_view tag) {
+                return value::make(operative{
+                    param_pattern{false, {"x", "y"}},
+                    "env",
+                    make_eval_expression(selected),
+                    env,
+                    tag});
+            };
+            return church_booleans{env, make_boolean("x", "true"), make_boolean("y", "false")};
+        }();
+        return booleans;
+    }
+
+    const value_ptr& church_true() { return get_church_booleans().true_value; }
+    const value_ptr& church_false() { return get_church_booleans().false_value; }
 
     // Evaluates argument
     // Returns Church Booleans
-    continuation_type nil_p_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type nil_p_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("nil?: expected 1 argument, got {}", args.size()),
-                args.empty() ? "(nil?)" : std::format("(nil? {} ...)", expr_context(args[0])),
-                call_stack::format()
-            );
-        }
-        
         auto val = eval(args[0], env);
-        return is_nil(val)? church_true(env): church_false(env);
+        return is_nil(val)? church_true(): church_false();
     }
 
-    continuation_type invoke_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type invoke_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("invoke: expected 2 arguments (operative arg-list), got {}", args.size()),
-                "invoke",
-                call_stack::format()
-            );
-        }
-
         auto op_expr = args[0];  // The operative to invoke (unevaluated)
         auto arg_list = eval(args[1], env);  // The list of arguments
         
@@ -841,15 +1249,15 @@ namespace builtins {
     }
 
     // Evaluates each argument
-    continuation_type do_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type do_operative(operand_span args, const env_root_ptr& env)
     {
         if (args.empty()) {
             // Empty do returns nil
-            return value::make(nullptr);
+            return constant_pool::nil();
         }
         
         try {
-            value_ptr result = value::make(nullptr); // default to nil
+            value_ptr result = constant_pool::nil(); // default to nil
             
             // Evaluate each expression in sequence, keeping the last result
             for (const auto& expr: std::ranges::subrange{args.begin(), args.end() - 1}) {
@@ -886,34 +1294,18 @@ namespace builtins {
     // In other cases, comparison against different types raises an error.
     // Comparison between true and true or false and false returns true.
     // All other comparisons between operatives always return false.
-    continuation_type equal_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type equal_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("=: expected 2 arguments, got {}", args.size()),
-                args.empty() ? "(=)" : 
-                args.size() == 1 ? std::format("(= {})", expr_context(args[0])) :
-                std::format("(= {} {} ...)", expr_context(args[0]), expr_context(args[1])),
-                call_stack::format()
-            );
-        }
-
         auto val1 = eval(args[0], env);
+        value_root_scope roots;
+        roots.add(val1);
         auto val2 = eval(args[1], env);
 
-        return (*val1 == *val2) ? church_true(env) : church_false(env);
+        return (*val1 == *val2) ? church_true() : church_false();
     }
 
-    continuation_type write_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type write_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("write: expected 1 argument, got {}", args.size()),
-                args.empty() ? "(write)" : std::format("(write {} ...)", expr_context(args[0])),
-                call_stack::format()
-            );
-        }
-        
         try {
             auto val = eval(args[0], env);
             std::print("{}", value_to_string(val));
@@ -929,22 +1321,14 @@ namespace builtins {
         }
     }
 
-    continuation_type display_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type display_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("display: expected 1 argument, got {}", args.size()),
-                args.empty() ? "(display)" : std::format("(display {} ...)", expr_context(args[0])),
-                call_stack::format()
-            );
-        }
-        
         try {
             auto val = eval(args[0], env);
             
             // Handle strings specially - output without quotes and interpret escapes
-            if (std::holds_alternative<std::string>(val->data)) {
-                std::print("{}", std::get<std::string>(val->data));
+            if (std::holds_alternative<boxed<std::string>>(val->data)) {
+                std::print("{}", std::get<boxed<std::string>>(val->data).get());
             } else {
                 // For non-strings, use the same as write
                 std::print("{}", value_to_string(val));
@@ -962,31 +1346,15 @@ namespace builtins {
         }
     }
 
-    continuation_type flush_operative(const std::vector<value_ptr>& args, env_root_ptr)
+    continuation_type flush_operative(operand_span, const env_root_ptr&)
     {
-        if (!args.empty()) {
-            throw evaluation_error(
-                std::format("flush: expected 0 arguments, got {}", args.size()),
-                args.empty() ? "(flush)" : std::format("(flush {} ...)", expr_context(args[0])),
-                call_stack::format()
-            );
-        }
-        
         // Flush the standard output
         std::fflush(stdout);
-        return value::make(nullptr);  // Return nil
+        return constant_pool::nil();  // Return nil
     }
 
-    continuation_type define_mutable_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type define_mutable_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("define-mutable: expected 2 arguments (symbol value), got {}", args.size()),
-                "define-mutable",
-                call_stack::format()
-            );
-        }
-        
         auto sym_expr = args[0];
         auto val_expr = args[1];
         
@@ -999,12 +1367,12 @@ namespace builtins {
         }
         
         try {
-            auto sym_name = std::get<symbol>(sym_expr->data).name;
+            auto name = std::get<symbol>(sym_expr->data).id;
             auto val = eval(val_expr, env);
             
             // Wrap the value in a mutable_binding
             auto mutable_val = value::make(mutable_binding{val});
-            env->define(sym_name, mutable_val);
+            env->define(name, mutable_val);
             return val;  // Return the original value, not the wrapper
         } catch (const evaluation_error&) {
             throw;
@@ -1017,16 +1385,8 @@ namespace builtins {
         }
     }
 
-    continuation_type set_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type set_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("set!: expected 2 arguments (symbol value), got {}", args.size()),
-                "set!",
-                call_stack::format()
-            );
-        }
-        
         auto sym_expr = args[0];
         auto val_expr = args[1];
         
@@ -1039,11 +1399,18 @@ namespace builtins {
         }
         
         try {
-            auto sym_name = std::get<symbol>(sym_expr->data).name;
+            const auto& sym = std::get<symbol>(sym_expr->data);
+            const auto& sym_name = sym.name();
             auto new_value = eval(val_expr, env);
             
-            // Look up the current binding
-            auto current_binding = env->lookup(sym_name);
+            // Look up the current binding, and the environment that holds it
+            environment* owner = env.get().get();
+            value* current_binding = nullptr;
+            for (; owner; owner = owner->get_parent()) {
+                current_binding = owner->find_local(sym.id);
+                if (current_binding) break;
+            }
+            if (not current_binding) throw std::runtime_error("Unbound variable: " + sym_name);
             
             // Check if it's mutable
             if (!std::holds_alternative<mutable_binding>(current_binding->data)) {
@@ -1056,6 +1423,7 @@ namespace builtins {
             
             // Update the mutable binding
             std::get<mutable_binding>(current_binding->data).value = new_value;
+            owner->note_write();
             return new_value;
             
         } catch (const evaluation_error&) {
@@ -1080,16 +1448,8 @@ namespace builtins {
     //
     // This is a stop-gap measure. I plan to revisit error handling in the
     // future, but I need something quick and dirty for now.
-    continuation_type try_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type try_operative(operand_span args, const env_root_ptr& env)
     {
-        if ((args.size() < 2) or (args.size() > 3)) {
-            throw evaluation_error(
-                std::format("try: expected 2 arguments (expr handler) or 3 (expr handler finally), got {}", args.size()),
-                "try",
-                call_stack::format()
-            );
-        }
-
         auto try_expr = args[0];
         auto handler_expr = args[1];
         value_ptr error_val;
@@ -1107,7 +1467,7 @@ namespace builtins {
         } catch (const std::exception& e) {
             error_val = make_list({
                 value::make(symbol{"error"}),
-                value::make(e.what()),
+                value::make(std::string{e.what()}),
                 value::make(std::string{}),  // context
                 value::make(std::string{})   // stack trace
             });
@@ -1143,21 +1503,13 @@ namespace builtins {
         return result;
     }
 
-    continuation_type raise_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type raise_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("raise: expected 1 argument (error-message), got {}", args.size()),
-                "raise",
-                call_stack::format()
-            );
-        }
-        
         auto message_val = eval(args[0], env);
         
         std::string message;
-        if (std::holds_alternative<std::string>(message_val->data)) {
-            message = std::get<std::string>(message_val->data);
+        if (std::holds_alternative<boxed<std::string>>(message_val->data)) {
+            message = std::get<boxed<std::string>>(message_val->data).get();
         } else {
             message = value_to_string(message_val);
         }
@@ -1165,34 +1517,157 @@ namespace builtins {
         throw evaluation_error(message, "", call_stack::format());
     }
 
-    continuation_type typeof_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type typeof_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("typeof: expected 1 argument, got {}", args.size()),
-                "typeof",
-                call_stack::format()
-            );
-        }
         auto arg = eval(args[0], env);
         std::string type = std::visit(typeof_visitor{}, arg->data);
         return value::make(symbol{type});
     }
 
-    continuation_type spaceship_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    value_ptr make_pair(std::string_view key, value_ptr val)
+    {
+        return value::make(cons_cell{value::make(symbol{key}), std::move(val)});
+    }
+
+    value_ptr heap_entry_to_alist(const heap_entry& entry, bool detailed)
+    {
+        std::vector<value_ptr> fields{
+            make_pair("live", constant_pool::make_number(entry.live)),
+            make_pair("peak", constant_pool::make_number(entry.peak)),
+            make_pair("bytes", constant_pool::make_number(entry.bytes)),
+        };
+        if (detailed) {
+            fields.push_back(make_pair("reached", constant_pool::make_number(entry.reached)));
+            fields.push_back(make_pair("payload-bytes", constant_pool::make_number(entry.payload_bytes)));
+        }
+        return make_pair(entry.type, vector_to_list(fields));
+    }
+
+    // (heap-stats) or (heap-stats detailed)
+    //
+    // Returns an association list:
+    // ((values (number (live . n) (peak . n) (bytes . n)) ...)
+    //  (environment (live . n) (peak . n) (bytes . n))
+    //  (pool (live-objects . n) (live-bytes . n) (slab-bytes . n)))
+    //
+    // The detailed version walks the heap to add reached and payload-bytes.
+    // See heap_stats.hpp.
+    continuation_type heap_stats_operative(operand_span args, const env_root_ptr&)
+    {
+        bool detailed{false};
+        if (not args.empty()) {
+            auto sym = std::get_if<symbol>(&args[0]->data);
+            if ((not sym) or ("detailed" != sym->name())) {
+                throw evaluation_error(
+                    "heap-stats: the only option is detailed",
+                    build_call_context("heap-stats", args),
+                    call_stack::format());
+            }
+            detailed = true;
+        }
+
+        auto report = get_heap_report(detailed);
+        std::vector<value_ptr> values;
+        for (const auto& entry: report.values) {
+            values.push_back(heap_entry_to_alist(entry, detailed));
+        }
+        return make_list({
+            make_pair("values", vector_to_list(values)),
+            heap_entry_to_alist(report.environments, detailed),
+            make_pair("pool", make_list({
+                make_pair("live-objects", constant_pool::make_number(report.pool.live_objects)),
+                make_pair("live-bytes", constant_pool::make_number(report.pool.live_bytes)),
+                make_pair("slab-bytes", constant_pool::make_number(report.pool.reserved_bytes)),
+            })),
+        });
+    }
+
+    value_ptr time_summary_to_alist(std::string_view name, const time_summary& times)
+    {
+        return make_pair(name, make_list({
+            make_pair("p50", constant_pool::make_number(times.p50.count())),
+            make_pair("p90", constant_pool::make_number(times.p90.count())),
+            make_pair("p99", constant_pool::make_number(times.p99.count())),
+            make_pair("max", constant_pool::make_number(times.max.count())),
+            make_pair("total", constant_pool::make_number(times.total.count())),
+        }));
+    }
+
+    value_ptr collection_summary_to_alist(const collection_summary& summary)
+    {
+        std::vector<value_ptr> histogram;
+        for (auto n: summary.histogram) histogram.push_back(constant_pool::make_number(n));
+        return make_pair(to_string(summary.kind), make_list({
+            make_pair("count", constant_pool::make_number(summary.pause.count)),
+            time_summary_to_alist("pause-ns", summary.pause),
+            time_summary_to_alist("mark-ns", summary.mark),
+            time_summary_to_alist("sweep-ns", summary.sweep),
+            make_pair("marked", constant_pool::make_number(summary.marked)),
+            make_pair("freed", constant_pool::make_number(summary.freed)),
+            make_pair("histogram", vector_to_list(histogram)),
+        }));
+    }
+
+    value_ptr collection_record_to_alist(const collection_record& record)
+    {
+        return make_list({
+            make_pair("kind", value::make(symbol{to_string(record.kind)})),
+            make_pair("trigger", value::make(symbol{to_string(record.trigger)})),
+            make_pair("start-ns", constant_pool::make_number(record.start.count())),
+            make_pair("mark-ns", constant_pool::make_number(record.mark_time.count())),
+            make_pair("sweep-ns", constant_pool::make_number(record.sweep_time.count())),
+            make_pair("registry", constant_pool::make_number(record.registry_size)),
+            make_pair("marked", constant_pool::make_number(record.marked)),
+            make_pair("swept", constant_pool::make_number(record.swept)),
+            make_pair("freed", constant_pool::make_number(record.freed)),
+        });
+    }
+
+    // (gc-stats) or (gc-stats records)
+    //
+    // Summarizes the collections in environment's log:
+    // ((records . n) (dropped . n) (span-ns . n) (collecting-ns . n)
+    //  (minor (count . n) (pause-ns (p50 . n) (p90 . n) (p99 . n) (max . n)
+    //   (total . n)) (mark-ns ...) (sweep-ns ...) (marked . n) (freed . n)
+    //   (histogram n ...))
+    //  (major ...))
+    //
+    // The histogram counts pauses by powers of two microseconds. The records
+    // version returns the records themselves, oldest first. See gc_stats.hpp.
+    continuation_type gc_stats_operative(operand_span args, const env_root_ptr&)
+    {
+        if (not args.empty()) {
+            auto sym = std::get_if<symbol>(&args[0]->data);
+            if ((not sym) or ("records" != sym->name())) {
+                throw evaluation_error(
+                    "gc-stats: the only option is records",
+                    build_call_context("gc-stats", args),
+                    call_stack::format());
+            }
+            std::vector<value_ptr> records;
+            environment::get_collection_log().for_each([&](const collection_record& record) {
+                records.push_back(collection_record_to_alist(record));
+            });
+            return vector_to_list(records);
+        }
+
+        auto summary = summarize_collections();
+        return make_list({
+            make_pair("records", constant_pool::make_number(summary.records)),
+            make_pair("dropped", constant_pool::make_number(summary.dropped)),
+            make_pair("span-ns", constant_pool::make_number(summary.span.count())),
+            make_pair("collecting-ns", constant_pool::make_number(summary.collecting.count())),
+            collection_summary_to_alist(summary.minor),
+            collection_summary_to_alist(summary.major),
+        });
+    }
+
+    continuation_type spaceship_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("<=>: expected 2 arguments, got {}", args.size()),
-                "<=>",
-                call_stack::format()
-            );
-        }
-
         auto left_unwrap  = unwrap_mutable_binding(eval(args[0], env));
         auto right_unwrap = unwrap_mutable_binding(eval(args[1], env));
-        auto left  = std::get_if<bignum>(&(left_unwrap->data));
-        auto right = std::get_if<bignum>(&(right_unwrap->data));
+        auto left  = std::get_if<number>(&(left_unwrap->data));
+        auto right = std::get_if<number>(&(right_unwrap->data));
 
         if ((not left) or (not right)) {
             throw evaluation_error(
@@ -1202,26 +1677,14 @@ namespace builtins {
             );
         }
 
-        int result{0};
-        if (*left < *right) {
-            result = -1;
-        } else if (*left > *right) {
-            result = 1;
-        }
-        return value::make(result);
+        auto order = *left <=> *right;
+        return constant_pool::make_number((order < 0)? -1: (order > 0)? 1: 0);
     }
 
-    continuation_type numerator_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type numerator_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("numerator: expected 1 argument, got {}", args.size()),
-                "numerator",
-                call_stack::format()
-            );
-        }
         auto val = eval(args[0], env);
-        auto n = std::get_if<bignum>(&val->data);
+        auto n = std::get_if<number>(&val->data);
         if (not n) {
             throw evaluation_error(
                 std::format("numerator: argument must be a number, got {}", value_to_string(val)),
@@ -1229,21 +1692,13 @@ namespace builtins {
                 call_stack::format()
             );
         }
-        bignum numerator = boost::multiprecision::numerator(*n);
-        return value::make(numerator);
+        return constant_pool::make_number(n->numerator());
     }
 
-    continuation_type denominator_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type denominator_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("denominator: expected 1 argument, got {}", args.size()),
-                "denominator",
-                call_stack::format()
-            );
-        }
         auto val = eval(args[0], env);
-        auto n = std::get_if<bignum>(&val->data);
+        auto n = std::get_if<number>(&val->data);
         if (not n) {
             throw evaluation_error(
                 std::format("denominator: argument must be a number, got {}", value_to_string(val)),
@@ -1251,25 +1706,16 @@ namespace builtins {
                 call_stack::format()
             );
         }
-        bignum denominator = boost::multiprecision::denominator(*n);
-        return value::make(denominator);
+        return constant_pool::make_number(n->denominator());
     }
 
-    continuation_type remainder_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type remainder_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 2) {
-            throw evaluation_error(
-                std::format("remainder: expected 2 arguments, got {}", args.size()),
-                "remainder",
-                call_stack::format()
-            );
-        }
-        
         auto val1 = eval(args[0], env);
         auto val2 = eval(args[1], env);
         
-        auto n1 = std::get_if<bignum>(&val1->data);
-        auto n2 = std::get_if<bignum>(&val2->data);
+        auto n1 = std::get_if<number>(&val1->data);
+        auto n2 = std::get_if<number>(&val2->data);
         if (not n1 or not n2) {
             throw evaluation_error(
                 "remainder: both arguments must be numbers",
@@ -1277,35 +1723,14 @@ namespace builtins {
                 call_stack::format()
             );
         }
-        
-        // For rationals: a remainder b = a - truncate(a/b) * b
-        bignum quotient = *n1 / *n2;
-        
-        // Truncate toward zero for rational numbers
-        // Convert to integer directly (this truncates toward zero)
-        using cpp_int = boost::multiprecision::cpp_int;
-        cpp_int truncated_int = boost::multiprecision::numerator(quotient) / 
-                            boost::multiprecision::denominator(quotient);
-        
-        // Convert back to bignum (rational)
-        bignum truncated_quotient{truncated_int};
-        
-        bignum result = *n1 - truncated_quotient * *n2;
-        return value::make(result);
+
+        return constant_pool::make_number(remainder(*n1, *n2));
     }
 
-    continuation_type string_to_list_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type string_to_list_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("string->list: expected 1 argument, got {}", args.size()),
-                "string->list",
-                call_stack::format()
-            );
-        }
-        
         auto str_val = eval(args[0], env);
-        if (!std::holds_alternative<std::string>(str_val->data)) {
+        if (!std::holds_alternative<boxed<std::string>>(str_val->data)) {
             throw evaluation_error(
                 std::format("string->list: argument must be a string, got {}", value_to_string(str_val)),
                 "string->list",
@@ -1313,35 +1738,34 @@ namespace builtins {
             );
         }
         
-        const auto& str = std::get<std::string>(str_val->data);
+        const auto& str = std::get<boxed<std::string>>(str_val->data).get();
         // Inefficient conversion but safer than a reinterpret_cast:
         // (There's an argument that `value` should use std::u8string instead.)
         const std::u8string utf8(str.begin(), str.end());
         const auto utf32 = utf8_to_utf32(utf8);
-        auto result = value::make(nullptr);
+        auto result = constant_pool::nil();
         
         // Build the list in reverse order
         for (auto it = utf32.rbegin(); it != utf32.rend(); ++it) {
             result = value::make(cons_cell{
-                value::make(bignum{*it}), result});
+                constant_pool::make_number(*it), result});
         }
         
         return result;
     }
 
-    char32_t bignum_to_char32(const bignum& rational)
+    char32_t number_to_char32(const number& n)
     {
-        namespace bmp = boost::multiprecision;
-        if (1 != bmp::denominator(rational)) {
+        if (not n.is_integer()) {
             throw std::invalid_argument("list->string: codepoint must be an integer");
         }
-        bmp::cpp_int numerator = bmp::numerator(rational);
-        if ((numerator < 0) or (numerator > 0x10FFFF)) {
+        // An integer that isn't a fixnum is too big to be a codepoint.
+        if ((not n.is_fixnum()) or (n.get_fixnum() < 0) or (n.get_fixnum() > 0x10FFFF)) {
             throw std::invalid_argument(
                 std::format("list->string: Invalid Unicode codepoint {} (must be 0-0x10FFFF)",
-                    numerator.str()));
+                    to_string(n)));
         }
-        char32_t codepoint = numerator.convert_to<char32_t>();
+        auto codepoint = static_cast<char32_t>(n.get_fixnum());
         if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
             throw std::invalid_argument(
                 std::format("list->string: Invalid Unicode codepoint U+{:X} (surrogate pair range not allowed)",
@@ -1350,16 +1774,8 @@ namespace builtins {
         return codepoint;
     }
 
-    continuation_type list_to_string_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type list_to_string_operative(operand_span args, const env_root_ptr& env)
     {
-        if (args.size() != 1) {
-            throw evaluation_error(
-                std::format("list->string: expected 1 argument, got {}", args.size()),
-                "list->string",
-                call_stack::format()
-            );
-        }
-        
         auto list_val = eval(args[0], env);
 
         if (std::holds_alternative<nullptr_t>(list_val->data)) {
@@ -1377,18 +1793,17 @@ namespace builtins {
         std::u32string result;
         auto current = list_val;
         
-        // Traverse the list and convert each bignum to char32_t
+        // Traverse the list and convert each number to char32_t
         while (std::holds_alternative<cons_cell>(current->data)) {
             const auto& cell = std::get<cons_cell>(current->data);
-            if (!std::holds_alternative<bignum>(cell.car->data)) {
+            if (!std::holds_alternative<number>(cell.car->data)) {
                 throw evaluation_error(
                     "list->string: all elements must be numbers",
                     "list->string",
                     call_stack::format()
                 );
             }
-            bignum bn = std::get<bignum>(cell.car->data);
-            result.push_back(bignum_to_char32(bn));
+            result.push_back(number_to_char32(std::get<number>(cell.car->data)));
             current = cell.cdr;
         }
 
@@ -1398,34 +1813,33 @@ namespace builtins {
         return value::make(s);
     }
 
-    continuation_type load_operative(const std::vector<value_ptr>& args, env_root_ptr env)
+    continuation_type load_operative(operand_span args, const env_root_ptr& env)
     {
-        if (1 != args.size()) {
-            throw evaluation_error("load: expected 1 argument (filename)", "load", call_stack::format());
-        }
-        
         auto filename_val = eval(args[0], env);
-        if (not std::holds_alternative<std::string>(filename_val->data)) {
+        if (not std::holds_alternative<boxed<std::string>>(filename_val->data)) {
             throw evaluation_error("load: filename must be a string", "load", call_stack::format());
         }
         
-        auto filename = std::get<std::string>(filename_val->data);
+        auto filename = std::get<boxed<std::string>>(filename_val->data).get();
         
         try {
             std::string content = read_file_content(filename);
             
             if (content.empty()) {
-                return value::make(nullptr); // Return nil for empty files
+                return constant_pool::nil(); // Return nil for empty files
             }
             
             parser p(content);
             auto expressions = p.parse_all();
             
-            value_ptr result = value::make(nullptr); // Default to nil
+            value_ptr result = constant_pool::nil(); // Default to nil
             
             // Evaluate each expression in sequence using top_level_eval
+            value_root_scope roots;
             for (const auto& expr : expressions) {
                 result = top_level_eval(expr, env);  // This is the key change
+                roots.clear();
+                roots.add(result);
             }
             
             return result; // Return result of last expression
@@ -1451,16 +1865,8 @@ namespace builtins {
         return parser{contents};
     }
 
-    continuation_type read_operative(const std::vector<value_ptr>& args, env_root_ptr)
+    continuation_type read_operative(operand_span, const env_root_ptr&)
     {
-        if (args.size() != 0) {
-            throw evaluation_error(
-                std::format("read: expected 0 arguments, got {}", args.size()),
-                "read",
-                call_stack::format()
-            );
-        }
-
         try {
             // We cheat and read all of stdin at once until we upgrade the parser.
             static parser stdin_parser{make_stdin_parser()};
@@ -1482,21 +1888,8 @@ namespace builtins {
 
 void add_church_boleans(env_root_ptr env)
 {
-    auto true_value = value::make(operative{
-            param_pattern{false, {"x", "y"}},
-            "env",
-            builtins::make_eval_expression("x"),
-            env,
-            "true"});
-    env->define("true", true_value);
-
-    auto false_value = value::make(operative{
-            param_pattern{false, {"x", "y"}},
-            "env",
-            builtins::make_eval_expression("y"),
-            env,
-            "false"});
-    env->define("false", false_value);
+    env->define("true", builtins::church_true());
+    env->define("false", builtins::church_false());
 }
 
 // Create a top-level environment with built-ins
@@ -1504,60 +1897,61 @@ env_root_ptr create_top_level_environment()
 {
     auto env = environment::make();
 
-    auto define_builtin = [env](const std::string& name, 
-                    std::function<continuation_type(const std::vector<value_ptr>&, env_root_ptr)> func)
+    auto define_builtin = [env](const std::string& name, builtin_function func,
+                    size_t min_args, size_t max_args)
     {
-        env->define(name, value::make(builtin_operative{name, std::move(func)}));
+        env->define(name, value::make(builtin_operative{name, func, min_args, max_args}));
     };
 
-    auto define_arithmetic = [define_builtin](const std::string& name, 
-                    std::function<bignum(bignum, bignum)> op)
-    {
-        define_builtin(name, builtins::make_arithmetic_operative(name, op));
-    };
+    constexpr auto variadic{builtin_operative::variadic};
 
     // Control
-    define_builtin("vau", builtins::vau_operative);
-    define_builtin("eval", builtins::eval_operative);
-    define_builtin("define", builtins::define_operative);
-    define_builtin("invoke", builtins::invoke_operative);
-    define_builtin("try", builtins::try_operative);
-    define_builtin("raise", builtins::raise_operative);
+    define_builtin("vau", builtins::vau_operative, 3, 3);
+    define_builtin("eval", builtins::eval_operative, 2, 2);
+    define_builtin("wrap", builtins::wrap_operative, 1, 1);
+    define_builtin("unwrap", builtins::unwrap_operative, 1, 1);
+    define_builtin("define", builtins::define_operative, 2, 2);
+    define_builtin("invoke", builtins::invoke_operative, 2, 2);
+    define_builtin("try", builtins::try_operative, 2, 3);
+    define_builtin("raise", builtins::raise_operative, 1, 1);
 #define USE_PRIMITIVE_DO
 #ifdef USE_PRIMITIVE_DO
-    define_builtin("do", builtins::do_operative);
+    define_builtin("do", builtins::do_operative, 0, variadic);
 #endif
-    define_builtin("load", builtins::load_operative);
-    define_builtin("read", builtins::read_operative);
+    define_builtin("load", builtins::load_operative, 1, 1);
+    define_builtin("read", builtins::read_operative, 0, 0);
     // Arithmetic
-    define_arithmetic("+", std::plus<bignum>{});
-    define_arithmetic("-", std::minus<bignum>{});
-    define_arithmetic("*", std::multiplies<bignum>{});
-    define_arithmetic("/", std::divides<bignum>{});
-    define_builtin("numerator", builtins::numerator_operative);
-    define_builtin("denominator", builtins::denominator_operative);
-    define_builtin("remainder", builtins::remainder_operative);
+    define_builtin("+", builtins::arithmetic_operative<builtins::add_op>, 1, variadic);
+    define_builtin("-", builtins::arithmetic_operative<builtins::subtract_op>, 1, variadic);
+    define_builtin("*", builtins::arithmetic_operative<builtins::multiply_op>, 1, variadic);
+    define_builtin("/", builtins::arithmetic_operative<builtins::divide_op>, 1, variadic);
+    define_builtin("numerator", builtins::numerator_operative, 1, 1);
+    define_builtin("denominator", builtins::denominator_operative, 1, 1);
+    define_builtin("remainder", builtins::remainder_operative, 2, 2);
     // Numeric comparison
-    define_builtin("<=>", builtins::spaceship_operative);
+    define_builtin("<=>", builtins::spaceship_operative, 2, 2);
     // Lists
-    define_builtin("cons", builtins::cons_operative);
-    define_builtin("first", builtins::first_operative);
-    define_builtin("rest", builtins::rest_operative);
-    define_builtin("nil?", builtins::nil_p_operative);
+    define_builtin("cons", builtins::cons_operative, 2, 2);
+    define_builtin("first", builtins::first_operative, 1, 1);
+    define_builtin("rest", builtins::rest_operative, 1, 1);
+    define_builtin("nil?", builtins::nil_p_operative, 1, 1);
     // Strings
-    define_builtin("string->list", builtins::string_to_list_operative);
-    define_builtin("list->string", builtins::list_to_string_operative);
+    define_builtin("string->list", builtins::string_to_list_operative, 1, 1);
+    define_builtin("list->string", builtins::list_to_string_operative, 1, 1);
     // Equality
-    define_builtin("=", builtins::equal_operative);
+    define_builtin("=", builtins::equal_operative, 2, 2);
     // I/O
-    define_builtin("write", builtins::write_operative);
-    define_builtin("display", builtins::display_operative);
-    define_builtin("flush", builtins::flush_operative);
+    define_builtin("write", builtins::write_operative, 1, 1);
+    define_builtin("display", builtins::display_operative, 1, 1);
+    define_builtin("flush", builtins::flush_operative, 0, 0);
     // Mutables
-    define_builtin("define-mutable", builtins::define_mutable_operative);
-    define_builtin("set!", builtins::set_operative);
+    define_builtin("define-mutable", builtins::define_mutable_operative, 2, 2);
+    define_builtin("set!", builtins::set_operative, 2, 2);
     // Reflection
-    define_builtin("typeof", builtins::typeof_operative);
+    define_builtin("typeof", builtins::typeof_operative, 1, 1);
+    // Memory
+    define_builtin("heap-stats", builtins::heap_stats_operative, 0, 1);
+    define_builtin("gc-stats", builtins::gc_stats_operative, 0, 1);
 
     add_church_boleans(env);
     return env;
@@ -1576,7 +1970,7 @@ void bind_parameters(const param_pattern& params, value_ptr operands, env_root_p
         }
         NOEVAL_DEBUG(env_binding, "Binding variadic parameter '{}' to all operands", 
                   params.param_names[0]);
-        target_env->define(params.param_names[0], operands);
+        target_env->bind_slot(0, operands);
     } else {
         // Fixed parameter case: convert operands to vector and bind individually
         auto operand_list = list_to_vector(operands);
@@ -1592,31 +1986,24 @@ void bind_parameters(const param_pattern& params, value_ptr operands, env_root_p
         }
         
         // Bind each parameter to its corresponding operand
-        for (const auto& [param_name, operand]: std::views::zip(params.param_names, operand_list)) {
-            target_env->define(param_name, operand);
+        // The parameters occupy the first slots, in order
+        for (size_t slot{0}; slot < operand_list.size(); ++slot) {
+            target_env->bind_slot(slot, operand_list[slot]);
         }
     }
 }
 
-continuation_type operate_operative(const operative& op, value_ptr operands, env_root_ptr env)
+// Binds the environment parameter of a frame whose parameters have been bound
+// and continues with the operative's body.
+continuation_type enter_operative_body(const operative& op, const env_root_ptr& new_env, const env_root_ptr& env)
 {
-    // Create new environment for the operative
-    auto new_env = environment::make(op.closure_env);
-
-    // Bind parameters to unevaluated operands
-    try {
-        bind_parameters(op.params, operands, new_env);
-    } catch (const evaluation_error& e) {
-        throw evaluation_error(std::format("{} {}", op.to_string(), e.what()), e.context, call_stack::format());
-    }
-
     // Bind environment parameter
     NOEVAL_DEBUG(env_binding, "Binding env parameter '{}' to environment {}", 
               op.env_param, to_string(env));
     // We use nil as the equivalent to Kernel's #ignore for vau's
     // environment parameter.
     if (not op.env_param.empty()) {
-        new_env->define(op.env_param, value::make(env.get()));
+        new_env->bind_slot(op.params.param_names.size(), value::make(env.get()));
     }
 
     // Evaluate body in new environment
@@ -1627,28 +2014,178 @@ continuation_type operate_operative(const operative& op, value_ptr operands, env
 #endif
 }
 
-continuation_type operate_builtin(const builtin_operative& op, value_ptr operands, env_root_ptr env)
+continuation_type operate_operative(const operative& op, const value_ptr& operands, const env_root_ptr& env)
+{
+    // Create new environment for the operative
+    auto new_env = environment::make_frame(op.closure_env, op.scope);
+
+    // Bind parameters to unevaluated operands
+    try {
+        bind_parameters(op.params, operands, new_env);
+    } catch (const evaluation_error& e) {
+        throw evaluation_error(std::format("{} {}", op.to_string(), e.what()), e.context, call_stack::format());
+    }
+
+    return enter_operative_body(op, new_env, env);
+}
+
+// Describes how many arguments a builtin accepts for error messages.
+std::string describe_arity(size_t min_args, size_t max_args)
+{
+    auto plural = [](size_t n) { return (1 == n)? "": "s"; };
+    if (min_args == max_args) {
+        return std::format("{} argument{}", min_args, plural(min_args));
+    }
+    if (builtin_operative::variadic == max_args) {
+        return std::format("at least {} argument{}", min_args, plural(min_args));
+    }
+    return std::format("{} to {} arguments", min_args, max_args);
+}
+
+// Most calls have only a few operands. Those are gathered into a buffer on
+// the stack so that dispatching the call doesn't allocate. Longer operand
+// lists fall back to a vector.
+//
+// The operands are often the only references to values that were just
+// evaluated, so the buffer roots them.
+class operand_buffer final {
+public:
+    static constexpr size_t inline_capacity{8};
+
+    void push_back(value_ptr operand)
+    {
+        roots.add(operand);
+        if (count < inline_capacity) {
+            inline_operands[count] = std::move(operand);
+        } else {
+            if (overflow.empty()) {
+                overflow.assign(inline_operands.begin(), inline_operands.end());
+            }
+            overflow.push_back(std::move(operand));
+        }
+        ++count;
+    }
+
+    size_t size() const { return count; }
+
+    operand_span span() const
+    {
+        return (count <= inline_capacity)?
+            operand_span{inline_operands.data(), count}:
+            operand_span{overflow};
+    }
+
+private:
+    std::array<value_ptr, inline_capacity> inline_operands;
+    std::vector<value_ptr> overflow;
+    size_t count{0};
+    value_root_scope roots;
+};
+
+// Calls f on each element of a list, which must be proper.
+void for_each_operand(const value_ptr& operands, auto&& f)
+{
+    const value* current = operands.get();
+    while (auto cell = std::get_if<cons_cell>(&current->data)) {
+        f(cell->car);
+        current = cell->cdr.get();
+    }
+    if (not std::holds_alternative<std::nullptr_t>(current->data)) {
+        throw std::runtime_error("Improper list");
+    }
+}
+
+continuation_type operate_builtin(const builtin_operative& op, const value_ptr& operands, const env_root_ptr& env)
 {
     NOEVAL_DEBUG(builtin, "Invoking builtin '{}' with operands: {}", 
               op.name, value_to_string(operands));
+
+    operand_buffer buffer;
+    for_each_operand(operands, [&](const value_ptr& operand) {
+        buffer.push_back(operand);
+    });
+    auto args = buffer.span();
+    auto count = args.size();
+
+    NOEVAL_DEBUG(builtin, "Converted to {} arguments", args.size());
+
+    // Builtins declare their arity, so it is checked here instead of in each
+    // of them.
+    if ((count < op.min_args) or (count > op.max_args)) {
+        throw evaluation_error(
+            std::format("{}: expected {}, got {}",
+                op.name, describe_arity(op.min_args, op.max_args), count),
+            build_call_context(op.name, args),
+            call_stack::format()
+        );
+    }
     
-    // Convert operands to vector for easier processing
-    auto operand_list = list_to_vector(operands);
-    
-    NOEVAL_DEBUG(builtin, "Converted to {} arguments", operand_list.size());
-    
-    // Call the built-in function with the evaluated operands
-    auto result = op.func(operand_list, env);
+    // Call the built-in function with the unevaluated operands
+    auto result = op.func(args, env);
     
     NOEVAL_DEBUG(builtin, "Builtin '{}' returned: {}", op.name, value_to_string(result));
     return result;
 }
 
-value_ptr eval_symbol(const symbol& sym, env_root_ptr env)
+// Returns a list of the operands of a call to a wrapped combiner, each
+// evaluated once per level of wrapping, like Kernel's applicatives.
+value_ptr evaluate_operands(value_ptr operands, const env_root_ptr& env, size_t wrap_count)
+{
+    for (; wrap_count > 0; --wrap_count) {
+        operand_buffer buffer;
+        for_each_operand(operands, [&](const value_ptr& operand) {
+            buffer.push_back(eval(operand, env));
+        });
+        operands = constant_pool::nil();
+        for (const auto& operand: buffer.span() | std::views::reverse) {
+            operands = value::make(cons_cell{operand, operands});
+        }
+    }
+    return operands;
+}
+
+// Calls a wrapped operative. In the common case of an operative wrapped once
+// with a fixed parameter list, the operands are evaluated into a buffer and
+// bound straight from there, without building a list of their values.
+continuation_type operate_wrapped_operative(const operative& op, const value_ptr& operands, const env_root_ptr& env)
+{
+    if ((1 != op.wrap_count) or op.params.is_variadic) {
+        return operate_operative(op, evaluate_operands(operands, env, op.wrap_count), env);
+    }
+
+    operand_buffer buffer;
+    for_each_operand(operands, [&](const value_ptr& operand) {
+        buffer.push_back(eval(operand, env));
+    });
+    auto args = buffer.span();
+    if (args.size() != op.params.param_names.size()) {
+        throw evaluation_error(
+            std::format("{} Wrong number of arguments: expected {}, got {}",
+                op.to_string(), op.params.param_names.size(), args.size()),
+            "",
+            call_stack::format()
+        );
+    }
+
+    auto new_env = environment::make_frame(op.closure_env, op.scope);
+    for (size_t slot{0}; slot < args.size(); ++slot) {
+        new_env->bind_slot(slot, args[slot]);
+    }
+    return enter_operative_body(op, new_env, env);
+}
+
+value_ptr eval_symbol(const symbol& sym, const env_root_ptr& env)
 {
+    if (auto slot = env->lookup_address(sym)) {
+        if (auto mb = std::get_if<mutable_binding>(&(*slot)->data)) {
+            return mb->value;
+        }
+        return *slot;
+    }
+
     // Look up the symbol in the environment
     try {
-        auto binding = env->lookup(sym.name);
+        auto binding = env->lookup(sym.id);
         
         // If it's a mutable binding, return the wrapped value
         if (std::holds_alternative<mutable_binding>(binding->data)) {
@@ -1657,41 +2194,139 @@ value_ptr eval_symbol(const symbol& sym, env_root_ptr env)
         
         return binding;
     } catch (const std::exception& e) {
-        throw evaluation_error(e.what(), sym.name, call_stack::format());
+        throw evaluation_error(e.what(), sym.name(), call_stack::format());
     }
 }
 
-continuation_type eval_operation(const cons_cell& cell, env_root_ptr env)
+// When a combination's operator is a symbol, this remembers what it resolved
+// to so the next evaluation can skip walking the environment chain.
+struct operator_cache_entry {
+    // The environment the lookup is keyed on (0 when the entry is empty)
+    std::uint64_t env_id{0};
+    // environment::get_generation() when the entry was filled
+    std::uint64_t generation{0};
+    symbol_id name{0};
+    // The binding itself (still wrapped if it is a mutable_binding, so that
+    // set! doesn't need to invalidate anything)
+    value* binding{nullptr};
+};
+
+// Direct mapped on the environment id and the name. Collisions just replace
+// the entry. (This used to be a field in every cons_cell, which made every
+// value bigger to help the few that are combinations.)
+constexpr size_t operator_cache_size{1024};
+std::array<operator_cache_entry, operator_cache_size> operator_cache;
+
+// Looks up the operator symbol of a combination, using the operator_cache
+// when it is still valid.
+//
+// The cache is keyed on the parent of the environment the lookup starts from
+// rather than the environment itself. Operative bodies are evaluated in a
+// fresh environment on every call, but its parent (the closure environment)
+// is the same each time. So a hit only has to check that the starting
+// environment doesn't bind the name itself (its parameters) and that nothing
+// the cached lookup depended on has changed since the cache was filled.
+// Environment ids are never reused, so an entry can't match the wrong
+// environment.
+//
+// Filling the cache marks the environments it searched as cached_through.
+// An environment::define into one of those (and garbage collection) bumps the
+// generation, which invalidates every entry. set! changes the value inside a
+// mutable_binding rather than the binding itself, and the cache holds the
+// binding, so it sees the new value without any invalidation.
+value_ptr resolve_operator(const symbol& sym, const env_root_ptr& env)
 {
-    // Convert cons_cell back to value_ptr for easier handling
-    auto expr = value::make(cell);
-    
-    if (is_nil(expr)) {
-        throw evaluation_error("Cannot evaluate empty list", "()", call_stack::format());
+    environment* start = env.get().get();
+    environment* key = start->get_parent()? start->get_parent(): start;
+    auto& cache = operator_cache[
+        ((key->get_id() * 0x9e3779b97f4a7c15ull) ^ sym.id) % operator_cache_size];
+
+    value* binding{nullptr};
+    if ((key != start) and (binding = start->find_local(sym.id))) {
+        // Shadowed by the starting environment; the cache doesn't apply.
+    } else if ((cache.env_id == key->get_id()) and
+               (cache.name == sym.id) and
+               (cache.generation == environment::get_generation()))
+    {
+        binding = cache.binding;
+    } else {
+        binding = key->lookup_for_cache(sym.id);
+        if (not binding) {
+            throw evaluation_error("Unbound variable: " + sym.name(), sym.name(), call_stack::format());
+        }
+        cache = {key->get_id(), environment::get_generation(), sym.id, binding};
     }
-    
-    auto operator_expr = car(expr);
-    auto operands = cdr(expr);
+
+    // The binding is kept alive by the environment it is bound in, but take
+    // a reference in case the operative redefines it while it runs.
+    value_ptr result{binding};
+    if (auto mb = std::get_if<mutable_binding>(&result->data)) {
+        return mb->value;
+    }
+    return result;
+}
+
+// Church booleans evaluate one of their two operands in the caller's
+// environment. Every conditional goes through one, so eval_operation
+// recognizes them and evaluates the selected operand directly instead of
+// creating an environment to run (eval x env) in.
+// Returns nullptr if op isn't a Church boolean or the operands don't fit, in
+// which case operate_operative should handle it (and report the error).
+const value_ptr* select_church_boolean_operand(const value_ptr& op, const value_ptr& operands)
+{
+    bool is_true = (op == builtins::church_true());
+    if ((not is_true) and (op != builtins::church_false())) return nullptr;
+    auto first = std::get_if<cons_cell>(&operands->data);
+    if (not first) return nullptr;
+    auto second = std::get_if<cons_cell>(&first->cdr->data);
+    if ((not second) or (not is_nil(second->cdr))) return nullptr;
+    return is_true? &first->car: &second->car;
+}
+
+// The expression is passed along with its cons cell so that the cell doesn't
+// have to be copied into a new value just to report errors.
+continuation_type eval_operation(const value_ptr& expr, const cons_cell& cell, const env_root_ptr& env)
+{
+    const auto& operator_expr = cell.car;
+    const auto& operands = cell.cdr;
     
     // Check if operator is already an operative value
     value_ptr op;
-    if (std::holds_alternative<operative>(operator_expr->data) || 
-        std::holds_alternative<builtin_operative>(operator_expr->data)) {
+    if (std::holds_alternative<boxed<operative>>(operator_expr->data) || 
+        std::holds_alternative<boxed<builtin_operative>>(operator_expr->data)) {
         // Use the operative directly
         op = operator_expr;
+    } else if (auto sym = std::get_if<symbol>(&operator_expr->data)) {
+        op = resolve_operator(*sym, env);
     } else {
         // Evaluate the operator expression
         op = eval(operator_expr, env);
     }
-    
+    // Evaluating the operands could collect, and this may be the only
+    // reference to the operative (and its closure environment).
+    value_root_scope roots;
+    roots.add(op);
+
     // Check if it's an operative
-    if (std::holds_alternative<operative>(op->data)) {
-        return operate_operative(std::get<operative>(op->data), operands, env);
+    if (auto boxed_combiner = std::get_if<boxed<operative>>(&op->data)) {
+        const operative* combiner = &boxed_combiner->get();
+        if (0 != combiner->wrap_count) {
+            return operate_wrapped_operative(*combiner, operands, env);
+        }
+        if (auto selected = select_church_boolean_operand(op, operands)) {
+            return tail_call{*selected, env};
+        }
+        return operate_operative(*combiner, operands, env);
     }
 
     // Check if it's a builtin operative
-    if (std::holds_alternative<builtin_operative>(op->data)) {
-        return operate_builtin(std::get<builtin_operative>(op->data), operands, env);
+    if (auto boxed_builtin = std::get_if<boxed<builtin_operative>>(&op->data)) {
+        const builtin_operative* builtin = &boxed_builtin->get();
+        if (0 != builtin->wrap_count) {
+            return operate_builtin(*builtin,
+                evaluate_operands(operands, env, builtin->wrap_count), env);
+        }
+        return operate_builtin(*builtin, operands, env);
     }
 
     throw evaluation_error(
@@ -1705,140 +2340,382 @@ continuation_type eval_operation(const cons_cell& cell, env_root_ptr env)
 
 env_root_ptr::env_root_ptr(env_ptr e): env(std::move(e))
 {
-    environment::add_root(env);
+    environment::add_root(env.get());
 }
 
 env_root_ptr::env_root_ptr(const env_root_ptr& that): env(that.env)
 {
-    environment::add_root(env);
+    environment::add_root(env.get());
 }
 
 env_root_ptr& env_root_ptr::operator=(const env_root_ptr& that)
 {
     if (this != &that) {
-        environment::remove_root(env);
+        environment::remove_root(env.get());
         env = that.env;
-        environment::add_root(env);
+        environment::add_root(env.get());
+    }
+    return *this;
+}
+
+env_root_ptr& env_root_ptr::operator=(env_root_ptr&& that) noexcept
+{
+    if (this != &that) {
+        environment::remove_root(env.get());
+        env = std::move(that.env);
     }
     return *this;
 }
 
 env_root_ptr::~env_root_ptr()
 {
-    environment::remove_root(env);
+    environment::remove_root(env.get());
 }
 
-void environment::add_root(env_ptr env)
+void environment::add_root(environment* env)
 {
     if (not env) return;
-    std::weak_ptr<environment> weak_env{env};
-    auto iter{roots.find(weak_env)};
-    if (iter != roots.end()) {
-        NOEVAL_DEBUG(gc_roots, "Incrementing root count: {}:{}", to_string(env), iter->second);
-        ++(iter->second);
-    } else {
-        NOEVAL_DEBUG(gc_roots, "Adding root: {}", to_string(env));
-        roots[weak_env] = 1;
-    }
+    NOEVAL_DEBUG(gc_roots, "Incrementing root count: {}:{}", static_cast<const void*>(env), env->root_count);
+    ++env->root_count;
 }
 
-void environment::remove_root(env_ptr env)
+void environment::remove_root(environment* env)
 {
     if (not env) return;
-    std::weak_ptr<environment> weak_env{env};
-    auto iter{roots.find(weak_env)};
-    if (iter != roots.end()) {
-        NOEVAL_DEBUG(gc_roots, "Decrementing root count: {}:{}", to_string(env), iter->second);
-        if (--(iter->second) == 0) {
-            NOEVAL_DEBUG(gc_roots, "Removing root: {}", to_string(env));
-            roots.erase(iter);
-        }
-    }
-}
-
-/*
- * We need to recursively check this values for env_ptrs:
- * `env_ptr`
- * `cons_cell::car`
- * `cons_cell::cdr`
- * `operative::closure_env`
- * `operative::body`?
- * `mutable_binding::value`
- */
-void environment::mark_value(std::unordered_set<environment*>& marked, value* v)
-{
-    if (not v) return;
-    if (std::holds_alternative<env_ptr>(v->data)) {
-        mark_environment(marked, std::get<env_ptr>(v->data).get());
-    } else if (std::holds_alternative<cons_cell>(v->data)) {
-        auto& cell = std::get<cons_cell>(v->data);
-        mark_value(marked, cell.car.get());
-        mark_value(marked, cell.cdr.get());
-    } else if (std::holds_alternative<operative>(v->data)) {
-        auto& op = std::get<operative>(v->data);
-        mark_environment(marked, op.closure_env.get());
-        mark_value(marked, op.body.get());
-    } else if (std::holds_alternative<mutable_binding>(v->data)) {
-        auto& mb = std::get<mutable_binding>(v->data);
-        mark_value(marked, mb.value.get());
-    }
-}
-
-void environment::mark_environment(std::unordered_set<environment*>& marked, environment* env)
+    NOEVAL_DEBUG(gc_roots, "Decrementing root count: {}:{}", static_cast<const void*>(env), env->root_count);
+    // The env_root_ptr letting go still has its reference. If anything else
+    // does too, the frame has escaped.
+    if ((0 == --env->root_count) and env->frame and (env->use_count() > 1)) {
+        env->register_frame();
+    }
+}
+
+// What's left to mark
+//
+// Marking pushes what it reaches onto these instead of recursing, so that
+// long lists and deep structures can't overflow the C++ stack, and the stack
+// use is bounded.
+struct environment::mark_stack {
+    bool young_only{false};
+    std::vector<environment*> environments;
+    std::vector<const value*> values;
+    // Values with more than one reference that have been pushed (When
+    // marking in parallel, each thread has its own, so a shared value can be
+    // traced by more than one thread. That's only wasted work.)
+    std::unordered_set<const value*> shared_values;
+    // How many values have been traced
+    size_t traced{0};
+
+    // Whether other threads are marking too
+    bool parallel{false};
+
+    void push(environment* env)
+    {
+        if ((not env) or env->is_marked() or (young_only and env->tenured)) return;
+        if (parallel) {
+            // Another thread may have reached it too. Only the one that
+            // marks it traces it. One that already has is seen here, and one
+            // that gets there after the load makes the exchange fail.
+            auto epoch = env->marked_epoch.load(std::memory_order_relaxed);
+            if (mark_epoch == epoch) return;
+            if (not env->marked_epoch.compare_exchange_strong(epoch, mark_epoch, std::memory_order_relaxed)) {
+                return;
+            }
+        } else {
+            env->marked_epoch.store(mark_epoch, std::memory_order_relaxed);
+        }
+        environments.push_back(env);
+    }
+
+    bool empty() const { return environments.empty() and values.empty(); }
+
+    // Whether v needs to be traced: it's one of the values that can refer to
+    // environments, and it hasn't been reached already
+    bool should_trace(const value* v)
+    {
+        if (not can_refer_to_environments(v)) return false;
+        // Values don't have a mark. A value with only one reference can only
+        // be reached through what holds it, and that is only traced once, so
+        // only shared values have to be remembered.
+        return (1 == v->use_count()) or shared_values.insert(v).second;
+    }
+
+    void push(const value* v)
+    {
+        if (should_trace(v)) values.push_back(v);
+    }
+
+    // These are the values that can:
+    // * `env_ptr`
+    // * `cons_cell::car`
+    // * `cons_cell::cdr`
+    // * `operative::closure_env`
+    // * `operative::body`
+    // * `mutable_binding::value`
+    //
+    // Most of what's reached is numbers and symbols, so this is checked
+    // before calling push.
+    static bool can_refer_to_environments(const value* v)
+    {
+        return v and (
+            std::holds_alternative<cons_cell>(v->data) or
+            std::holds_alternative<env_ptr>(v->data) or
+            std::holds_alternative<boxed<operative>>(v->data) or
+            std::holds_alternative<mutable_binding>(v->data));
+    }
+};
+
+void environment::mark_reachable(mark_stack& stack, size_t budget)
 {
-    if (not env) return;
-    if (marked.contains(env)) return;
-    marked.insert(env);
-    mark_environment(marked, env->parent.get());
-    for (const auto& binding: env->bindings) {
-        mark_value(marked, binding.second.get());
+    while (0 != budget) {
+        if (not stack.values.empty()) {
+            const value* v = stack.values.back();
+            stack.values.pop_back();
+            // Lists are most of what gets marked, so follow cdrs here rather
+            // than pushing them. (Looking at the cdr before the car measured
+            // much faster on long lists.)
+            while (v) {
+                if (0 == budget--) {
+                    stack.values.push_back(v);
+                    return;
+                }
+                ++stack.traced;
+                const value* next = nullptr;
+                if (auto cell = std::get_if<cons_cell>(&v->data)) {
+                    if (stack.should_trace(cell->cdr.get())) next = cell->cdr.get();
+                    if (mark_stack::can_refer_to_environments(cell->car.get())) stack.push(cell->car.get());
+                } else if (auto env = std::get_if<env_ptr>(&v->data)) {
+                    stack.push(env->get());
+                } else if (auto op = std::get_if<boxed<operative>>(&v->data)) {
+                    stack.push((*op)->closure_env.get());
+                    stack.push((*op)->body.get());
+                } else if (auto mb = std::get_if<mutable_binding>(&v->data)) {
+                    stack.push(mb->value.get());
+                }
+                v = next;
+            }
+        } else if (not stack.environments.empty()) {
+            --budget;
+            environment* env = stack.environments.back();
+            stack.environments.pop_back();
+            stack.push(env->parent.get());
+            env->bindings.for_each([&](symbol_id, const value_ptr& binding) {
+                stack.push(binding.get());
+            });
+        } else {
+            break;
+        }
+    }
+}
+
+void environment::mark(bool young_only)
+{
+    if (0 == ++mark_epoch) {
+        // It wrapped around, so old marks could look current.
+        for_each_registered([](environment& env) { env.marked_epoch.store(0, std::memory_order_relaxed); });
+        mark_epoch = 1;
+    }
+    // Kept between collections, so they don't have to grow each time
+    static mark_stack stack;
+    stack.young_only = young_only;
+    stack.shared_values.clear();
+    stack.traced = 0;
+    for (auto env = registry; env; env = env->registry_next) {
+        if (young_only and env->tenured) break;
+        if (0 != env->root_count) stack.push(env);
+    }
+    if (young_only) {
+        for (const auto& env: remembered_set) {
+            env->bindings.for_each([&](symbol_id, const value_ptr& binding) {
+                stack.push(binding.get());
+            });
+        }
+    }
+    value_root_scope::for_each([&](const value* v) { stack.push(v); });
+    auto threads = policy.get_mark_threads();
+    if ((not young_only) and (threads > 1) and
+        (0 != policy.parallel_threshold) and (registered_count >= policy.parallel_threshold))
+    {
+        mark_in_parallel(stack, threads);
+    } else {
+        mark_reachable(stack);
     }
+    traced_count = stack.traced;
 }
 
-std::unordered_set<environment*> environment::mark()
+// Work that a thread marking in parallel has given up for others to take
+struct environment::mark_deque {
+    struct chunk {
+        std::vector<environment*> environments;
+        std::vector<const value*> values;
+    };
+
+    std::mutex mutex;
+    std::deque<chunk> chunks;
+    // So threads can look for work without taking the lock
+    std::atomic<size_t> size{0};
+
+    // Moves the oldest half of the stack's work here
+    void give(mark_stack& stack)
+    {
+        chunk c;
+        auto move_half = [](auto& from, auto& to) {
+            auto half = from.begin() + from.size() / 2;
+            to.assign(from.begin(), half);
+            from.erase(from.begin(), half);
+        };
+        move_half(stack.environments, c.environments);
+        move_half(stack.values, c.values);
+        std::scoped_lock lock{mutex};
+        chunks.push_back(std::move(c));
+        ++size;
+    }
+
+    bool take(mark_stack& stack)
+    {
+        if (0 == size.load(std::memory_order_relaxed)) return false;
+        std::scoped_lock lock{mutex};
+        if (chunks.empty()) return false;
+        auto& c = chunks.front();
+        stack.environments.insert(stack.environments.end(), c.environments.begin(), c.environments.end());
+        stack.values.insert(stack.values.end(), c.values.begin(), c.values.end());
+        chunks.pop_front();
+        --size;
+        return true;
+    }
+};
+
+// Each thread marks from its own stack. Whenever some thread is idle, a busy
+// one gives half of its stack to its deque, and idle threads take work from
+// any deque (their own first). Marking is done when no thread has any work.
+// Only the main thread runs the interpreter, so everything else that marking
+// looks at is just read.
+void environment::mark_in_parallel(mark_stack& roots, size_t thread_count)
 {
-    std::unordered_set<environment*> marked;
-    for (const auto& [root, count]: roots) {
-        if (count == 0) continue;
-        if (auto p = root.lock()) {
-            mark_environment(marked, p.get());
+    // How much each thread traces before checking whether to share
+    constexpr size_t batch{1024};
+    std::vector<mark_deque> deques(thread_count);
+    // The threads that are tracing or might still find something to. Each
+    // helper is counted before it starts, so that none can see 0 early.
+    std::atomic<size_t> active{1};
+    std::atomic<size_t> helpers_traced{0};
+
+    auto take_any = [&](mark_stack& stack, size_t self) {
+        for (size_t i{0}; i < thread_count; ++i) {
+            if (deques[(self + i) % thread_count].take(stack)) return true;
+        }
+        return false;
+    };
+    auto any_work = [&] {
+        return std::ranges::any_of(deques, [](const mark_deque& d) { return 0 != d.size.load(); });
+    };
+    auto work = [&](mark_stack& stack, size_t self) {
+        stack.parallel = true;
+        while (true) {
+            mark_reachable(stack, batch);
+            if (not stack.empty()) {
+                if ((active.load() < thread_count) and (0 == deques[self].size.load(std::memory_order_relaxed))) {
+                    deques[self].give(stack);
+                }
+                continue;
+            }
+            if (take_any(stack, self)) continue;
+            // Idle. Work only gets shared by active threads, so once none
+            // are, there's none left.
+            --active;
+            while (true) {
+                if (0 == active.load()) return;
+                if (any_work()) {
+                    ++active;
+                    if (take_any(stack, self)) break;
+                    --active;
+                }
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> helpers;
+        for (size_t i{1}; i < thread_count; ++i) {
+            ++active;
+            try {
+                helpers.emplace_back([&, i] {
+                    mark_stack stack;
+                    stack.young_only = roots.young_only;
+                    work(stack, i);
+                    helpers_traced += stack.traced;
+                });
+            } catch (const std::system_error& e) {
+                // Mark with the ones that did start
+                --active;
+                NOEVAL_DEBUG(gc, "Marking with {} threads: {}", i, e.what());
+                break;
+            }
         }
+        work(roots, 0);
     }
-    return marked;
+    roots.parallel = false;
+    roots.traced += helpers_traced;
+    ++parallel_mark_count;
 }
 
-void environment::sweep(std::unordered_set<environment*>& marked)
+// Sweeps the young environments, or all of them, and tenures the survivors
+void environment::sweep(bool young_only, collection_record& record)
 {
-    for (const auto& entry: registry) {
-        auto p = entry.lock();
-        if (not p) continue;
-        if (marked.contains(p.get())) continue;
-        p->bindings.clear();
-        p->parent.reset();
+    // Breaking the cycles destroys environments, so take the garbage out of
+    // the registry first, and hold on to it until all of it has been broken.
+    std::vector<env_ptr> garbage;
+    for (auto env = registry; env; ) {
+        if (young_only and env->tenured) break;
+        auto next = env->registry_next;
+        ++record.swept;
+        if (not env->is_marked()) {
+            garbage.emplace_back(env);
+            env->unregister();
+        } else if (not env->tenured) {
+            env->tenured = true;
+            ++tenured_count;
+        }
+        env = next;
+    }
+    record.freed = garbage.size();
+    record.marked = record.swept - record.freed;
+    for (const auto& env: garbage) {
+        env->bindings.clear();
+        env->parent.reset();
     }
 }
 
-void environment::cleanup_registry()
+// Everything surviving a collection is tenured, so nothing tenured refers to
+// anything young anymore.
+void environment::forget_remembered()
 {
-    std::erase_if(roots, [](const auto& entry) {
-        return entry.first.expired() or (entry.second == 0);
-    });
-    std::erase_if(registry, [](const auto& entry) {
-        return entry.expired();
-    });
+    for (const auto& env: remembered_set) env->remembered = false;
+    remembered_set.clear();
 }
 
 env_root_ptr environment::make()
 {
-    auto env = std::shared_ptr<environment>(new environment);
-    registry.insert(env);
+    auto env = env_ptr(new environment);
     return env_root_ptr(env);
 }
 
 env_root_ptr environment::make(env_ptr parent)
 {
-    auto env = std::shared_ptr<environment>(new environment(std::move(parent)));
-    registry.insert(env);
+    auto env = env_ptr(new environment(std::move(parent)));
+    return env_root_ptr(env);
+}
+
+env_root_ptr environment::make(env_ptr parent, const lexical_scope* scope)
+{
+    auto env = env_ptr(new environment(std::move(parent), scope));
+    return env_root_ptr(env);
+}
+
+env_root_ptr environment::make_frame(env_ptr parent, const lexical_scope* scope)
+{
+    auto env = env_ptr(new environment(std::move(parent), scope, true));
     return env_root_ptr(env);
 }
 
@@ -1847,31 +2724,108 @@ env_root_ptr environment::make(env_root_ptr parent)
     return make(parent.get());
 }
 
-void environment::collect()
+namespace {
+    const auto program_start = std::chrono::steady_clock::now();
+}
+
+void environment::finish_collection(collection_record& record,
+    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point marked)
+{
+    auto end = std::chrono::steady_clock::now();
+    record.start = start - program_start;
+    record.mark_time = marked - start;
+    record.sweep_time = end - marked;
+    collections.add(record);
+    log_collection(record);
+}
+
+void environment::collect(collection_trigger trigger)
 {
     NOEVAL_DEBUG(gc, "Before collection: Undestructed environments: {}", environment::get_constructed_count());
     NOEVAL_DEBUG(gc, "Before collection: Registered environments  : {}", environment::get_registered_count());
     if (NOEVAL_DEBUG_ENABLED(gc_roots)) dump_roots();
-    cleanup_registry();
-    auto marked = mark();
-    sweep(marked);
-    cleanup_registry();
+    auto start = std::chrono::steady_clock::now();
+    collection_record record{.kind = collection_kind::major, .trigger = trigger};
+    register_frames();
+    record.registry_size = registered_count;
+    // The remembered set isn't needed, and holding on to its environments
+    // would keep garbage from being destroyed.
+    forget_remembered();
+    mark(false);
+    auto marked = std::chrono::steady_clock::now();
+    sweep(false, record);
+    // Sweeping clears bindings, so cached lookups can't be trusted anymore.
+    ++generation;
+    made_since_collection = 0;
+    tenured_after_major = tenured_count;
+    // Sweeping is when big structures get freed, so this is a good time to
+    // give the pool's empty slabs back.
+    pool_trim();
+    finish_collection(record, start, marked);
+    major_stats.add(record.pause());
     NOEVAL_DEBUG(gc, "After collection : Undestructed environments: {}", environment::get_constructed_count());
     NOEVAL_DEBUG(gc, "After collection : Registered environments  : {}", environment::get_registered_count());
+    NOEVAL_DEBUG(gc, "After collection : Max constructed          : {}", environment::get_peak_constructed_count());
     if (NOEVAL_DEBUG_ENABLED(gc_roots)) dump_roots();
 }
 
+void environment::collect_minor(collection_trigger trigger)
+{
+    NOEVAL_DEBUG(gc, "Before minor collection: Registered environments: {}", environment::get_registered_count());
+    NOEVAL_DEBUG(gc, "Before minor collection: Remembered environments: {}", remembered_set.size());
+    auto start = std::chrono::steady_clock::now();
+    collection_record record{.kind = collection_kind::minor, .trigger = trigger};
+    register_frames();
+    record.registry_size = registered_count;
+    mark(true);
+    forget_remembered();
+    auto marked = std::chrono::steady_clock::now();
+    sweep(true, record);
+    ++generation;
+    made_since_collection = 0;
+    finish_collection(record, start, marked);
+    minor_stats.add(record.pause());
+    NOEVAL_DEBUG(gc, "After minor collection : Registered environments: {}", environment::get_registered_count());
+    NOEVAL_DEBUG(gc, "After minor collection : Tenured environments   : {}", tenured_count);
+}
+
+size_t gc_policy::get_mark_threads() const
+{
+    return std::min<size_t>(mark_threads_max, mark_threads? mark_threads: std::thread::hardware_concurrency());
+}
+
+bool set_gc_option(std::string_view name, std::string_view value)
+{
+    auto parse = [value](auto& setting) {
+        auto parsed = setting;
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+        if ((std::errc{} != error) or (value.data() + value.size() != end) or (parsed < 0)) {
+            return false;
+        }
+        setting = parsed;
+        return true;
+    };
+    auto& policy = environment::get_gc_policy();
+    if ("threshold" == name) return parse(policy.allocation_threshold);
+    if ("growth" == name) return parse(policy.growth_ratio);
+    if ("min-heap" == name) return parse(policy.minimum_heap);
+    if ("parallel-threshold" == name) return parse(policy.parallel_threshold);
+    if ("mark-threads" == name) {
+        auto threads = policy.mark_threads;
+        if ((not parse(threads)) or (threads > gc_policy::mark_threads_max)) return false;
+        policy.mark_threads = threads;
+        return true;
+    }
+    return false;
+}
+
 void environment::dump_roots()
 {
     NOEVAL_DEBUG(gc_roots, "Roots:");
-    for (const auto& [entry, count]: roots) {
-        auto p = entry.lock();
-        if (p) {
-            NOEVAL_DEBUG(gc_roots, "\t{}:{}", to_string(p), count);
-        } else {
-            NOEVAL_DEBUG(gc_roots, "\t<expired>:{}", count);
-        }
-    }
+    for_each_environment([](environment& env) {
+        if (0 == env.root_count) return;
+        NOEVAL_DEBUG(gc_roots, "\t{}:{}", to_string(env_ptr{&env}), env.root_count);
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1901,6 +2855,10 @@ private:
 value_ptr eval(value_ptr expr, env_root_ptr env)
 {
     call_stack::guard g(expr);
+    // A tail call can replace expr with the body of an operative that
+    // nothing else refers to anymore.
+    value_root_scope roots;
+    roots.add(expr);
     while (true) {
         NOEVAL_DEBUG(eval, "{}[{}] Evaluating({}): {}", 
             call_stack::indent(), 
@@ -1911,14 +2869,14 @@ value_ptr eval(value_ptr expr, env_root_ptr env)
             continuation_type k = std::visit([&](const auto& v) -> continuation_type {
                 using T = std::decay_t<decltype(v)>;
                 
-                if constexpr (std::is_same_v<T, bignum> || 
-                            std::is_same_v<T, std::string> || 
+                if constexpr (std::is_same_v<T, number> || 
+                            std::is_same_v<T, boxed<std::string>> || 
                             std::is_same_v<T, std::nullptr_t>) {
                     return expr;
                 } else if constexpr (std::is_same_v<T, symbol>) {
                     return eval_symbol(v, env);
                 } else if constexpr (std::is_same_v<T, cons_cell>) {
-                    return eval_operation(v, env);
+                    return eval_operation(expr, v, env);
                 } else {
                     throw evaluation_error(
                         std::format("Cannot evaluate {}", demangle<T>()),
@@ -1928,9 +2886,14 @@ value_ptr eval(value_ptr expr, env_root_ptr env)
                 }
             }, expr->data);
             if (auto tc{std::get_if<tail_call>(&k)}) {
-                expr = tc->expr;
-                env = tc->env;
+                expr = std::move(tc->expr);
+                env = std::move(tc->env);
+                roots.clear();
+                roots.add(expr);
                 NOEVAL_DEBUG(tco, "Tail call!");
+                // A safe point: everything in use is rooted. This is what
+                // lets long loops reclaim their frames.
+                environment::maybe_collect();
                 continue;
             }
             auto result{std::get<value_ptr>(k)};
@@ -1954,7 +2917,9 @@ value_ptr top_level_eval(value_ptr expr, env_root_ptr env)
 {
     auto eval_and_collect = [&]() {
         auto result{eval(expr, env)};
-        environment::collect();
+        value_root_scope roots;
+        roots.add(result);
+        environment::maybe_collect();
         return result;
     };
     if (NOEVAL_DEBUG_ENABLED(timer)) {
@@ -2142,9 +3107,36 @@ env_root_ptr reload_top_level_environment(bool test_the_library)
 
 int main(const int argc, const char** argv)
 {
-    std::vector<std::string> args(argv + 1, argv + argc);
+    std::vector<std::string> args;
+    bool stress_tests{false};
+    for (std::string_view arg: std::span(argv + 1, argv + argc)) {
+        if ("--stress-tests" == arg) {
+            stress_tests = true;
+        } else if (arg.starts_with("--gc-log=")) {
+            // --gc-log=<file>; see open_collection_file
+            auto path = std::string{arg.substr(9)};
+            if (not open_collection_file(path)) {
+                std::println("Can't open {}", path);
+                return EXIT_FAILURE;
+            }
+        } else if (arg.starts_with("--gc-")) {
+            // --gc-<setting>=<value>; see set_gc_option
+            arg.remove_prefix(5);
+            auto equals = arg.find('=');
+            if ((std::string_view::npos == equals) or
+                (not set_gc_option(arg.substr(0, equals), arg.substr(equals + 1))))
+            {
+                std::println("Bad option: --gc-{}", arg);
+                std::println("Options: --gc-threshold=<n> --gc-growth=<ratio> --gc-min-heap=<n>"
+                    " --gc-parallel-threshold=<n> --gc-mark-threads=<n> --gc-log=<file>");
+                return EXIT_FAILURE;
+            }
+        } else {
+            args.emplace_back(arg);
+        }
+    }
 
-    if (!run_tests()) {
+    if (!run_tests(stress_tests)) {
         std::print("Tests failed. Do you want to continue anyway? (y/N): ");
         std::string response;
         std::getline(std::cin, response);
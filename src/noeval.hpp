@@ -1,7 +1,14 @@
 #pragma once
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -10,19 +17,26 @@
 #include <variant>
 #include <vector>
 
-#include <boost/multiprecision/cpp_int.hpp>
-
-using bignum = boost::multiprecision::cpp_rational;
+#include "allocation.hpp"
+#include "number.hpp"
+#include "ref_ptr.hpp"
 
 // Forward declarations
 struct environment;
 struct value;
 
-using value_ptr = std::shared_ptr<value>;
-using env_ptr = std::shared_ptr<environment>;
+using value_ptr = ref_ptr<value>;
+using env_ptr = ref_ptr<environment>;
+
+// Called by ref_ptr when the last reference goes away
+void ref_ptr_delete(value* v);
+inline void ref_ptr_delete(environment* env);
 
 // Used to ensure that environments referenced only by the C++ code do not get
 // collected.
+//
+// Each one adds to its environment's root count, and moving one just passes
+// that along.
 class env_root_ptr final {
     env_ptr env;
 public:
@@ -36,23 +50,43 @@ public:
     env_root_ptr(const env_root_ptr& that);
     env_root_ptr& operator=(const env_root_ptr& that);
 
-#if 0
-    // Add move constructor and assignment
-    env_root_ptr(env_root_ptr&& that) noexcept: env(std::move(that.env))
+    // Move operations
+    env_root_ptr(env_root_ptr&& that) noexcept: env(std::move(that.env)) {}
+    env_root_ptr& operator=(env_root_ptr&& that) noexcept;
+};
+
+// Roots values that only C++ code refers to
+//
+// Collection can happen in the middle of an evaluation (see eval), and it
+// keeps only the environments reachable from roots. An env_root_ptr roots an
+// environment, but a value that only a C++ frame holds--an evaluated operand,
+// or an operative about to be called--can refer to environments that nothing
+// else does. Those values are added to a value_root_scope for as long as the
+// frame needs them.
+//
+// Scopes are only made on the stack, so they nest. Each one just remembers
+// where its values start on a shared stack.
+class value_root_scope final {
+public:
+    value_root_scope(): base{stack.size()} {}
+    ~value_root_scope() { stack.resize(base); }
+    value_root_scope(const value_root_scope&) = delete;
+    value_root_scope& operator=(const value_root_scope&) = delete;
+
+    // The value must be kept alive while it is in the scope, at least
+    // whenever a collection could happen.
+    void add(const value_ptr& v) { stack.push_back(v.get()); }
+    // Removes the values this scope added
+    void clear() { stack.resize(base); }
+
+    static void for_each(auto&& f)
     {
-        that.env = nullptr; // Prevent destructor from removing
+        for (auto v: stack) f(v);
     }
-    
-    env_root_ptr& operator=(env_root_ptr&& that) noexcept
-    {
-        if (this != &that) {
-            if (env) environment::remove_root(env);
-            env = std::move(that.env);
-            that.env = nullptr;
-        }
-        return *this;
-    }
-#endif
+
+private:
+    static inline std::vector<const value*> stack;
+    size_t base;
 };
 
 // Tail call captures the eval arguments for the next iteration of eval when
@@ -68,13 +102,51 @@ struct tail_call {
 // value.
 using continuation_type = std::variant<tail_call, value_ptr>;
 
+// Symbols are interned. Every symbol with the same name gets the same id, so
+// comparing symbols and looking them up in environments doesn't need to look
+// at the name. Names are never removed from the table.
+using symbol_id = std::uint32_t;
+symbol_id intern_symbol(std::string_view name);
+const std::string& symbol_name(symbol_id id);
+
+// Describes the frames an operative's calls create: the names bound to its
+// parameters (and its environment parameter) in slot order, and the scope of
+// the frame it closed over. Scopes are interned, so operatives with the same
+// parameters closing over frames of the same scope share one. That way a
+// lexical_address can be checked against an environment with a pointer
+// comparison.
+struct lexical_scope {
+    std::vector<symbol_id> names;
+    const lexical_scope* parent;
+
+    static const lexical_scope* intern(std::vector<symbol_id> names,
+        const lexical_scope* parent);
+    // Returns the slot name is bound to in frames of this scope, or -1.
+    // Later names win, so the environment parameter shadows a parameter with
+    // the same name, like it did before slots.
+    std::ptrdiff_t find(symbol_id name) const;
+};
+
+// Where a symbol is bound, relative to a frame of the given scope: depth
+// parents up, in the given slot. This is only a hint. The same symbol can be
+// evaluated in environments of other scopes, and then it is looked up by name.
+struct lexical_address {
+    const lexical_scope* scope{nullptr};
+    std::uint16_t depth{0};
+    std::uint16_t slot{0};
+};
+
 // Core value types
 struct symbol {
-    std::string name;
-    explicit symbol(std::convertible_to<std::string_view> auto&& n):
-        name{std::forward<decltype(n)>(n)} {}
-    std::string to_string() const { return name; }
-    bool operator==(const symbol& that) const { return name == that.name; }
+    // Filled in by the analysis done when an operative is created.
+    // See assign_lexical_addresses.
+    // (This comes first so that id fits in its padding.)
+    [[no_unique_address]] mutable lexical_address address;
+    symbol_id id;
+    explicit symbol(std::string_view n): id{intern_symbol(n)} {}
+    const std::string& name() const { return symbol_name(id); }
+    std::string to_string() const { return name(); }
+    bool operator==(const symbol& that) const { return id == that.id; }
 };
 
 struct cons_cell {
@@ -97,11 +169,15 @@ struct operative {
     value_ptr body;
     env_ptr closure_env;
     std::string tag;
+    // The scope of the environments operate_operative creates for this
+    const lexical_scope* scope;
+    // How many times calls evaluate each operand before binding it. Nonzero
+    // makes this what Kernel calls an applicative. See the wrap builtin.
+    size_t wrap_count{0};
     
+    // This also assigns lexical addresses to the symbols in the body.
     operative(param_pattern p, std::string e, value_ptr b, env_root_ptr env,
-        std::string_view t = "")
-        : params(std::move(p)), env_param(std::move(e)),
-          body(std::move(b)), closure_env(std::move(env.get())), tag(t) {}
+        std::string_view t = "");
 
     std::string to_string() const;
     bool operator==(const operative& that) const
@@ -111,14 +187,30 @@ struct operative {
     }
 };
 
+// The unevaluated operands of a builtin call. These usually point into a
+// buffer on operate_builtin's stack, so builtins must not hold on to the span.
+using operand_span = std::span<const value_ptr>;
+
+// Builtins are plain functions. The dispatcher checks the operand count
+// against the declared arity before calling them.
+using builtin_function = continuation_type (*)(operand_span, const env_root_ptr&);
+
 // Built-in operative type for primitives
 struct builtin_operative {
-    std::string name;
-    std::function<continuation_type(const std::vector<value_ptr>&, env_root_ptr)> func;
+    // Used as max_args when there is no upper limit
+    static constexpr size_t variadic{std::numeric_limits<size_t>::max()};
 
-    builtin_operative(std::string n, std::function<continuation_type(const std::vector<value_ptr>&, env_root_ptr)> f)
-        : name(std::move(n)), func(std::move(f)) {}
-    std::string to_string() const { return "#<builtin-operative:" + name + ">"; }
+    std::string name;
+    builtin_function func;
+    size_t min_args;
+    size_t max_args;
+    // Like operative::wrap_count. The operands are evaluated before the
+    // builtin gets them (and it may evaluate them again).
+    size_t wrap_count{0};
+
+    builtin_operative(std::string n, builtin_function f, size_t min, size_t max)
+        : name(std::move(n)), func(f), min_args(min), max_args(max) {}
+    std::string to_string() const;
     bool operator==(const builtin_operative&) const { return false; }
 };
 
@@ -136,6 +228,15 @@ struct eof_object {
     bool operator==(const eof_object&) const { return true; }
 };
 
+// How many objects of a kind exist, and the most there have been at once.
+// Updated as values and environments are made and destroyed. See heap_stats.
+struct heap_count {
+    size_t live{0};
+    size_t peak{0};
+    void add() { if (++live > peak) peak = live; }
+    void remove() { --live; }
+};
+
 // The main value type
 /*
 We could use Church encoding for integers, but the performance overhead and
@@ -144,106 +245,589 @@ more sense.
 
 We could also use Church encoding for cons cells, but--likewise--this has
 impractical performance overhead.
+
+Most values are cons cells, small numbers, symbols, and nil, and a value is as
+big as its biggest alternative. So anything bigger than two pointers is boxed
+(see boxed<T>), and the reference count goes in the variant's padding instead
+of a ref_counted base class.
 */
-struct value: std::enable_shared_from_this<value> {
-    std::variant<
-        bignum,
-        std::string,
+struct value {
+    using data_type = std::variant<
+        number,
+        boxed<std::string>,
         symbol,
         cons_cell,
-        operative,
-        builtin_operative,
+        boxed<operative>,
+        boxed<builtin_operative>,
         env_ptr,
         mutable_binding,
         eof_object,
         std::nullptr_t  // for nil
-    > data;
+    >;
+    static constexpr size_t type_count{std::variant_size_v<data_type>};
+
+    [[no_unique_address]] data_type data;
+
+    std::uint32_t use_count() const { return ref_count; }
+
+    // Live values with the alternative at the given index in data_type
+    static const heap_count& get_live_count(size_t index) { return live_counts[index]; }
 
 private:
-#if 0
-    static inline int object_count{0};
-    template<typename T>
-    value(T&& t): data(std::forward<T>(t)) { ++object_count; /*std::println("objects: {}", object_count);*/ }
-public:
-    ~value() { --object_count; std::println("objects: {}", object_count); }
-#else
+    template<typename T> friend class ref_ptr;
+    mutable std::uint32_t ref_count{0};
+
+    static inline std::array<heap_count, type_count> live_counts;
+
     template<typename T>
-    value(T&& t): data(std::forward<T>(t)) {}
-#endif
+    value(T&& t): data(std::forward<T>(t)) { live_counts[data.index()].add(); }
 
 public:
+    ~value() { live_counts[data.index()].remove(); }
+
     template<typename T>
-    static std::shared_ptr<value> make(T&& v)
+    static value_ptr make(T&& v)
     {
-        return std::shared_ptr<value>(new value(std::forward<T>(v)));
+        return value_ptr{new value(std::forward<T>(v))};
     }
 
-    static std::shared_ptr<value> make(env_root_ptr env)
+    static value_ptr make(env_root_ptr env)
     {
         return value::make(env.get());
     }
 
+    static void* operator new(std::size_t size) { return pool_allocate(size); }
+    static void operator delete(void* p, std::size_t size) { pool_deallocate(p, size); }
+
     friend bool operator==(value& lhs, value& rhs);
 };
 
+static_assert(alignof(value) <= pool_granularity);
+static_assert(sizeof(value) <= 24, "a payload needs to be boxed");
+
+// Shared instances of values that are made over and over
+//
+// Values are never changed in place--set! changes what a mutable_binding
+// refers to, not the value--so equal nils, numbers, and strings can be the
+// same value. (The Church booleans are already shared. See
+// get_church_booleans.)
+//
+// Small integers are made the first time they're needed and kept. String
+// literals from the parser are kept by their contents, so they last as long
+// as the interpreter does.
+class constant_pool final {
+public:
+    static constexpr number::fixnum small_integer_min{-128};
+    static constexpr number::fixnum small_integer_max{1023};
+
+    static value_ptr nil();
+    static value_ptr eof();
+    // The shared value for a small integer, or a new value for anything else
+    static value_ptr make_number(number n);
+
+    // String literals are shared while they're short and the table has
+    // room, so it stays bounded however many strings the reader sees.
+    static constexpr size_t literal_length_max{64};
+    static constexpr size_t literal_count_max{4096};
+    static value_ptr make_literal(const std::string& s);
+    static size_t get_literal_count();
+
+    // Hits are requests answered with an existing value. Misses made a new
+    // value, whether or not it was kept.
+    static size_t get_hits() { return hits; }
+    static size_t get_misses() { return misses; }
+
+private:
+    static inline size_t hits{0};
+    static inline size_t misses{0};
+};
+
 struct typeof_visitor {
-    std::string operator()(const bignum&) const { return "number"; }
-    std::string operator()(const std::string&) const { return "string"; }
+    std::string operator()(const number&) const { return "number"; }
+    std::string operator()(const boxed<std::string>&) const { return "string"; }
     std::string operator()(const symbol&) const { return "symbol"; }
     std::string operator()(const cons_cell&) const { return "cons-cell"; }
-    std::string operator()(const operative&) const { return "operative"; }
-    std::string operator()(const builtin_operative&) const { return "operative"; }
+    std::string operator()(const boxed<operative>&) const { return "operative"; }
+    std::string operator()(const boxed<builtin_operative>&) const { return "operative"; }
     std::string operator()(env_ptr) const { return "environment"; }
     std::string operator()(const mutable_binding& mb) const;
     std::string operator()(const eof_object&) const { return "eof-object"; }
     std::string operator()(std::nullptr_t) const { return "nil"; }
 };
 
+// An environment's bindings. Most environments are call frames with only a
+// few bindings, so the first few are stored inline and found by linear search
+// instead of paying for a hash table. The rest go in a vector, and an index is
+// built once there are too many to search linearly.
+//
+// A binding's position never changes, which is what lets lexical addresses
+// refer to an operative's parameters (always the first bindings) by slot.
+class binding_table final {
+public:
+    // Enough for the common case of a few parameters and an environment
+    // parameter
+    static constexpr size_t inline_capacity{5};
+    static constexpr size_t index_threshold{16};
+
+    size_t size() const { return count; }
+    // If a name is bound more than once, the latest binding is found.
+    value_ptr* find(symbol_id name);
+    const value_ptr* find(symbol_id name) const;
+    // Adds a binding without checking whether name is already bound
+    void append(symbol_id name, value_ptr val);
+    value_ptr& at(size_t position)
+    {
+        return (position < inline_capacity)?
+            inline_values[position]: overflow[position - inline_capacity].second;
+    }
+    const value_ptr& at(size_t position) const
+    { return const_cast<binding_table*>(this)->at(position); }
+    void clear();
+    // Approximate bytes allocated for the bindings that aren't inline
+    size_t heap_bytes() const;
+
+    // Calls f(name, value) for each binding
+    void for_each(auto&& f) const
+    {
+        for (size_t i{0}; i < std::min<size_t>(count, inline_capacity); ++i) {
+            f(inline_names[i], inline_values[i]);
+        }
+        for (const auto& [name, val]: overflow) f(name, val);
+    }
+
+private:
+    // Kept separate so the linear search only has to touch the names
+    std::array<symbol_id, inline_capacity> inline_names{};
+    // Fits in the padding after inline_names
+    std::uint32_t count{0};
+    std::array<value_ptr, inline_capacity> inline_values;
+    std::vector<std::pair<symbol_id, value_ptr>> overflow;
+    // Maps names to positions once count passes index_threshold
+    std::unique_ptr<std::unordered_map<symbol_id, size_t>> index;
+};
+
+enum class collection_kind { none, minor, major };
+
+// Decides when environment::maybe_collect collects, and how much
+//
+// Collecting after every top-level form meant that loading a file was mostly
+// marking the same heap over and over. Instead, a minor collection happens
+// once enough environments have been made since the last collection. It only
+// looks at those young environments, since most of them (call frames) are
+// garbage by then. A major collection, of everything, happens once the
+// tenured environments (the ones that have survived a collection) have grown
+// enough since the last one. Lower limits collect more often, for shorter
+// pauses and less memory, but more time spent collecting.
+struct gc_policy {
+    // Collect once this many environments have been made since the last
+    // collection. (0 collects every time.)
+    size_t allocation_threshold{10000};
+    // Collect everything once there are this many times as many tenured
+    // environments as the last major collection left...
+    double growth_ratio{2.0};
+    // ...but only once there are at least this many.
+    size_t minimum_heap{1000};
+    // Major collections mark with several threads once there are at least
+    // this many environments. (0 never does.) It's off until it's been shown
+    // to be faster on a machine with more than one core.
+    size_t parallel_threshold{0};
+    // How many threads a parallel mark uses. (0 uses one per core.) It's
+    // never more than mark_threads_max.
+    static constexpr size_t mark_threads_max{64};
+    size_t mark_threads{0};
+
+    // The threads a parallel mark would use
+    size_t get_mark_threads() const;
+
+    collection_kind should_collect(size_t made_since_collection, size_t tenured,
+        size_t tenured_after_major) const
+    {
+        if ((tenured >= minimum_heap) and (tenured >= growth_ratio * tenured_after_major)) {
+            return collection_kind::major;
+        }
+        if (made_since_collection >= allocation_threshold) return collection_kind::minor;
+        return collection_kind::none;
+    }
+};
+
+// How many collections of one kind there have been and how long they took
+struct collection_stats {
+    size_t count{0};
+    std::chrono::nanoseconds total_pause{0};
+    std::chrono::nanoseconds longest_pause{0};
+
+    void add(std::chrono::nanoseconds pause)
+    {
+        ++count;
+        total_pause += pause;
+        longest_pause = std::max(longest_pause, pause);
+    }
+};
+
+// Why a collection happened
+enum class collection_trigger {
+    // The policy's allocation threshold (minor collections)
+    allocation,
+    // The policy's growth ratio (major collections)
+    growth,
+    // Asked for by environment::collect or collect_minor
+    request,
+};
+
+// What one collection did
+struct collection_record {
+    collection_kind kind{collection_kind::none};
+    collection_trigger trigger{collection_trigger::request};
+    // When it started, since the program did
+    std::chrono::nanoseconds start{0};
+    // Marking includes registering frames and setting up the roots, and
+    // sweeping includes giving empty slabs back to the heap.
+    std::chrono::nanoseconds mark_time{0};
+    std::chrono::nanoseconds sweep_time{0};
+    // Registered environments when it started
+    size_t registry_size{0};
+    // Of the environments the sweep looked at, the ones that were marked and
+    // the ones that weren't and were freed
+    size_t marked{0};
+    size_t swept{0};
+    size_t freed{0};
+
+    std::chrono::nanoseconds pause() const { return mark_time + sweep_time; }
+};
+
+// The most recent collection records, oldest first
+//
+// This has a fixed size, so keeping it doesn't take more memory the longer
+// the program runs. See gc_stats.hpp for what's done with it.
+class collection_log final {
+public:
+    static constexpr size_t capacity{1024};
+
+    void add(const collection_record& record)
+    {
+        records[total % capacity] = record;
+        ++total;
+    }
+
+    size_t size() const { return std::min(total, capacity); }
+    // Including the ones that have been overwritten
+    size_t get_total() const { return total; }
+
+    void for_each(auto&& f) const
+    {
+        for (size_t i{total - size()}; i < total; ++i) f(records[i % capacity]);
+    }
+
+private:
+    std::array<collection_record, capacity> records;
+    size_t total{0};
+};
+
+// Sets environment::get_gc_policy()'s threshold, growth, min-heap,
+// parallel-threshold, or mark-threads from text, for the REPL and the command
+// line. Returns false if the name or the value isn't valid.
+bool set_gc_option(std::string_view name, std::string_view value);
+
 // Environment for variable bindings
-struct environment final {
+struct environment final: ref_counted {
 private:
     // Keep a count of all constructed (& not destructed) environments for debugging
-    static inline size_t count{0};
+    static inline heap_count count;
 
     // Registry of all environments used for garbage collection
-    // weak_ptr can't be used with unordered_set until owner_hash is implemented
-    static inline std::set<std::weak_ptr<environment>, std::owner_less<std::weak_ptr<environment>>> registry;
-    // Roots with reference counts:
-    static inline std::map<std::weak_ptr<environment>, size_t, std::owner_less<std::weak_ptr<environment>>> roots;
-
-    std::unordered_map<std::string, value_ptr> bindings;
+    //
+    // This is an intrusive doubly linked list (see registry_prev and
+    // registry_next), so registering and unregistering take constant time
+    // and don't allocate. Environments register themselves when they are
+    // constructed and unregister when they are destroyed, so everything in
+    // here is alive. Collection unregisters its garbage before breaking the
+    // garbage's cycles, so unregistering does nothing for environments that
+    // collection destroys.
+    static inline environment* registry{nullptr};
+    static inline size_t registered_count{0};
+
+    // Frames
+    //
+    // Most of the environments operate_operative makes are only ever used by
+    // the C++ code that evaluates the body, and they're destroyed by their
+    // reference count when it's done. Nothing else refers to them, so they
+    // can't be in a cycle, and collection has nothing to do with them. Those
+    // are made with make_frame, and kept out of the registry (in this list,
+    // linked the same way) until it turns out that they escape: when the
+    // last env_root_ptr lets go of one that something else still refers to.
+    // Whatever frames there are when a collection starts are registered
+    // first, so collection sees the same heap as if they had been registered
+    // all along.
+    static inline environment* frames{nullptr};
+    static inline size_t frames_made{0};
+    static inline size_t frames_registered{0};
+
+    // Generations
+    //
+    // Environments start out young, and are tenured when they survive a
+    // collection. New environments go on the front of the registry, so the
+    // young ones are always the ones before the first tenured one.
+    //
+    // A minor collection only marks and sweeps the young environments. It
+    // treats the tenured ones as live, and only looks inside the ones that
+    // might refer to young environments. Those are in the remembered set.
+    // Storing into a binding is the only way a tenured environment can come
+    // to refer to a younger one. (Parents are always older, values are
+    // immutable except for mutable_binding, and a closure that captures a
+    // young environment has to be stored somewhere to be kept.) So define,
+    // bind_slot, and set! add tenured environments to the remembered set.
+    static inline std::vector<env_ptr> remembered_set;
+    static inline size_t tenured_count{0};
+
+    static inline gc_policy policy;
+    // For the policy
+    static inline size_t made_since_collection{0};
+    static inline size_t tenured_after_major{0};
+    static inline collection_stats minor_stats;
+    static inline collection_stats major_stats;
+    static inline collection_log collections;
+    static inline std::uint32_t mark_epoch{0};
+    static inline size_t parallel_mark_count{0};
+    static inline size_t traced_count{0};
+
+    // Bumped whenever a binding that a cached lookup might depend on changes.
+    // See resolve_operator.
+    static inline std::uint64_t generation{0};
+    // Source of unique ids. Unlike addresses, these are never reused.
+    static inline std::uint64_t next_id{1};
+
+    // This is marked when it's the same as mark_epoch, so starting a new
+    // mark unmarks everything without touching it. (It's first so that it
+    // fits in the padding after ref_counted's count.) It's atomic so that
+    // threads marking in parallel can race to mark it.
+    std::atomic<std::uint32_t> marked_epoch{0};
+    binding_table bindings;
     env_ptr parent;
+    // In environments created by operate_operative, the first bindings are
+    // the operative's parameters, in the order of scope->names. Those
+    // positions are the slots in a lexical_address.
+    const lexical_scope* scope{nullptr};
+    std::uint64_t id;
+    // The number of env_root_ptrs holding this environment. Collection
+    // starts marking from every environment where this isn't zero.
+    std::uint32_t root_count{0};
+    // Set once a cached lookup has searched this environment. Only defines
+    // into such environments need to bump the generation.
+    bool cached_through{false};
+    bool registered{false};
+    // Whether this is in frames
+    bool frame{false};
+    bool tenured{false};
+    // Whether this is in the remembered set
+    bool remembered{false};
+    environment* registry_prev{nullptr};
+    environment* registry_next{nullptr};
 
     // Private ctor; must use environment::make to create instances
-    environment(env_ptr p = nullptr) : parent(std::move(p)) { ++count; }
+    environment(env_ptr p = nullptr, const lexical_scope* s = nullptr, bool as_frame = false)
+        : parent(std::move(p)), scope(s), id(next_id++)
+    {
+        if (scope) {
+            for (auto name: scope->names) bindings.append(name, nullptr);
+        }
+        count.add();
+        if (as_frame) {
+            link_into(frames);
+            frame = true;
+            ++frames_made;
+        } else {
+            ++made_since_collection;
+            add_to_registry();
+        }
+    }
 
-    static void cleanup_registry();
-    static std::unordered_set<environment*> mark();
-    static void mark_value(std::unordered_set<environment*>& marked, value* v);
-    static void mark_environment(std::unordered_set<environment*>& marked, environment* env);
-    static void sweep(std::unordered_set<environment*>& marked);
+    void link_into(environment*& list)
+    {
+        registry_next = list;
+        if (list) list->registry_prev = this;
+        list = this;
+    }
+
+    void unlink_from(environment*& list)
+    {
+        if (registry_prev) {
+            registry_prev->registry_next = registry_next;
+        } else {
+            list = registry_next;
+        }
+        if (registry_next) registry_next->registry_prev = registry_prev;
+        registry_prev = registry_next = nullptr;
+    }
+
+    void add_to_registry()
+    {
+        link_into(registry);
+        registered = true;
+        ++registered_count;
+    }
+
+    // Does nothing if this has already been unregistered
+    void unregister()
+    {
+        if (not registered) return;
+        unlink_from(registry);
+        registered = false;
+        --registered_count;
+        if (tenured) --tenured_count;
+    }
+
+    // Moves a frame into the registry, as a new environment
+    void register_frame()
+    {
+        unlink_from(frames);
+        frame = false;
+        ++frames_registered;
+        ++made_since_collection;
+        add_to_registry();
+    }
+
+    static void register_frames()
+    {
+        while (frames) frames->register_frame();
+    }
+
+    bool is_marked() const { return mark_epoch == marked_epoch.load(std::memory_order_relaxed); }
+
+    // When young_only is set, tenured environments count as marked, and
+    // marking doesn't go into them.
+    struct mark_stack;
+    struct mark_deque;
+    static void mark(bool young_only);
+    // Marks from the stack until it is empty, or until it has traced
+    // budget things
+    static void mark_reachable(mark_stack& stack, size_t budget = std::numeric_limits<size_t>::max());
+    static void mark_in_parallel(mark_stack& roots, size_t thread_count);
+    // Fills in the record's marked, swept, and freed
+    static void sweep(bool young_only, collection_record& record);
+    static void forget_remembered();
+    // Fills in the record's times, and logs it
+    static void finish_collection(collection_record& record,
+        std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point marked);
 
 public:
-    static void collect();
-    static size_t get_constructed_count() { return count; }
-    static size_t get_registered_count() { return registry.size(); }
+    // A major collection
+    static void collect(collection_trigger trigger = collection_trigger::request);
+    static void collect_minor(collection_trigger trigger = collection_trigger::request);
+    // Collects if the policy says to. Returns whether it did.
+    //
+    // This is called between top-level forms and on tail calls, so everything
+    // the C++ code is using has to be rooted, with env_root_ptr and
+    // value_root_scope.
+    static bool maybe_collect()
+    {
+        switch (policy.should_collect(made_since_collection, tenured_count, tenured_after_major)) {
+        case collection_kind::none:
+            return false;
+        case collection_kind::minor:
+            collect_minor(collection_trigger::allocation);
+            return true;
+        case collection_kind::major:
+            collect(collection_trigger::growth);
+            return true;
+        }
+        return false;
+    }
+    static gc_policy& get_gc_policy() { return policy; }
+    static size_t get_collection_count() { return minor_stats.count + major_stats.count; }
+    static const collection_stats& get_minor_stats() { return minor_stats; }
+    static const collection_stats& get_major_stats() { return major_stats; }
+    static const collection_log& get_collection_log() { return collections; }
+    static size_t get_tenured_count() { return tenured_count; }
+    static size_t get_remembered_count() { return remembered_set.size(); }
+    static size_t get_parallel_mark_count() { return parallel_mark_count; }
+    // How many values the last mark traced
+    static size_t get_traced_count() { return traced_count; }
+    static size_t get_made_since_collection() { return made_since_collection; }
+    static size_t get_constructed_count() { return count.live; }
+    static size_t get_peak_constructed_count() { return count.peak; }
+    static size_t get_registered_count() { return registered_count; }
+    // Frames made, and how many of them were registered
+    static size_t get_frames_made() { return frames_made; }
+    static size_t get_frames_registered() { return frames_registered; }
+    bool is_frame() const { return frame; }
     static void dump_roots();
-    static void add_root(env_ptr env);
-    static void remove_root(env_ptr env);
+    static void add_root(environment* env);
+    static void remove_root(environment* env);
     static std::vector<std::string> get_root_symbols();
 
     static env_root_ptr make();
     static env_root_ptr make(env_ptr parent);
     static env_root_ptr make(env_root_ptr parent);
+    static env_root_ptr make(env_ptr parent, const lexical_scope* scope);
+    // For operate_operative (see frames)
+    static env_root_ptr make_frame(env_ptr parent, const lexical_scope* scope);
 
-    ~environment() { --count; }
+    static void* operator new(std::size_t size) { return pool_allocate(size); }
+    static void operator delete(void* p, std::size_t size) { pool_deallocate(p, size); }
 
-    value_ptr lookup(const std::string& name) const;
-    void define(const std::string& name, value_ptr val);
+    ~environment()
+    {
+        if (frame) unlink_from(frames);
+        unregister();
+        count.remove();
+    }
+
+    static std::uint64_t get_generation() { return generation; }
+
+    value_ptr lookup(symbol_id name) const;
+    value_ptr lookup(std::string_view name) const { return lookup(intern_symbol(name)); }
+    // Returns the binding in this environment only, or nullptr.
+    value* find_local(symbol_id name) const;
+    // Like lookup, but marks every environment searched as cached_through.
+    // Returns nullptr if the name is unbound.
+    value* lookup_for_cache(symbol_id name);
+    void define(symbol_id name, value_ptr val);
+    void define(std::string_view name, value_ptr val) { define(intern_symbol(name), std::move(val)); }
+    // Like define, but only for binding the parameters of an environment that
+    // operate_operative just created. Nothing can have cached a lookup through
+    // it yet, so this doesn't need to invalidate caches.
+    void bind_slot(size_t slot, value_ptr val);
+    // Follows sym.address if it applies to this environment. Returns nullptr
+    // if it doesn't, and the symbol has to be looked up by name.
+    const value_ptr* lookup_address(const symbol& sym) const;
+    const lexical_scope* get_scope() const { return scope; }
+    std::uint64_t get_id() const { return id; }
+    std::uint32_t get_root_count() const { return root_count; }
+    bool is_tenured() const { return tenured; }
+    // The write barrier. define and bind_slot call this, and so must
+    // anything that changes what a binding refers to in place (like set!
+    // changing a mutable_binding).
+    void note_write()
+    {
+        if (tenured and not remembered) {
+            remembered = true;
+            remembered_set.emplace_back(this);
+        }
+    }
+    environment* get_parent() const { return parent.get(); }
     std::vector<std::string> get_all_symbols() const;
     std::string dump_chain() const;
+
+    // Calls f(env) for each registered environment. f must not make or
+    // destroy environments.
+    static void for_each_registered(auto&& f)
+    {
+        for (auto env = registry; env; env = env->registry_next) f(*env);
+    }
+    // Calls f(env) for each environment that hasn't been destroyed: the
+    // registered ones and the frames that haven't been registered yet. f must
+    // not make or destroy environments.
+    static void for_each_environment(auto&& f)
+    {
+        for_each_registered(f);
+        for (auto env = frames; env; env = env->registry_next) f(*env);
+    }
+    const binding_table& get_bindings() const { return bindings; }
 };
 
+inline void ref_ptr_delete(environment* env) { delete env; }
+static_assert(alignof(environment) <= pool_granularity);
+
 // Custom exception class with context
 class evaluation_error: public std::runtime_error {
 public:
@@ -284,6 +868,7 @@ bool is_cons(const value_ptr& val);
 value_ptr car(const value_ptr& val);
 value_ptr cdr(const value_ptr& val);
 std::vector<value_ptr> list_to_vector(value_ptr list);
+value_ptr vector_to_list(const std::vector<value_ptr>& elements);
 
 // Core evaluation functions
 value_ptr eval(value_ptr expr, env_root_ptr env);
@@ -294,7 +879,7 @@ env_root_ptr create_top_level_environment();
 env_root_ptr reload_top_level_environment(bool test_the_library = true);
 
 // String conversion functions
-std::string to_string(const bignum& value);
+std::string to_string(const number& value);
 std::string to_string(const std::string& value);
 std::string to_string(std::nullptr_t);
 std::string to_string(const env_ptr& env);
@@ -0,0 +1,119 @@
+#include "number.hpp"
+
+using cpp_int = boost::multiprecision::cpp_int;
+
+number::number(const bignum& n)
+{
+    namespace bmp = boost::multiprecision;
+    if ((1 == bmp::denominator(n)) and
+        (bmp::numerator(n) >= std::numeric_limits<fixnum>::min()) and
+        (bmp::numerator(n) <= std::numeric_limits<fixnum>::max()))
+    {
+        rep = bmp::numerator(n).convert_to<fixnum>();
+    } else {
+        rep = boxed<bignum>{n};
+    }
+}
+
+bool number::is_integer() const
+{
+    if (is_fixnum()) return true;
+    return 1 == boost::multiprecision::denominator(get_bignum());
+}
+
+bignum number::to_bignum() const
+{
+    if (is_fixnum()) return bignum{get_fixnum()};
+    return get_bignum();
+}
+
+number number::numerator() const
+{
+    if (is_fixnum()) return *this;
+    return cpp_int{boost::multiprecision::numerator(get_bignum())};
+}
+
+number number::denominator() const
+{
+    if (is_fixnum()) return 1;
+    return cpp_int{boost::multiprecision::denominator(get_bignum())};
+}
+
+number operator+(const number& a, const number& b)
+{
+    if (a.is_fixnum() and b.is_fixnum()) {
+        number::fixnum result;
+        if (not __builtin_add_overflow(a.get_fixnum(), b.get_fixnum(), &result)) return result;
+    }
+    bignum result = a.to_bignum() + b.to_bignum();
+    return result;
+}
+
+number operator-(const number& a, const number& b)
+{
+    if (a.is_fixnum() and b.is_fixnum()) {
+        number::fixnum result;
+        if (not __builtin_sub_overflow(a.get_fixnum(), b.get_fixnum(), &result)) return result;
+    }
+    bignum result = a.to_bignum() - b.to_bignum();
+    return result;
+}
+
+number operator*(const number& a, const number& b)
+{
+    if (a.is_fixnum() and b.is_fixnum()) {
+        number::fixnum result;
+        if (not __builtin_mul_overflow(a.get_fixnum(), b.get_fixnum(), &result)) return result;
+    }
+    bignum result = a.to_bignum() * b.to_bignum();
+    return result;
+}
+
+number operator/(const number& a, const number& b)
+{
+    if (a.is_fixnum() and b.is_fixnum()) {
+        auto x = a.get_fixnum();
+        auto y = b.get_fixnum();
+        // Division by zero is left to bignum so that it throws the same way.
+        // The minimum divided by -1 is the one quotient that overflows.
+        bool overflows = (-1 == y) and (std::numeric_limits<number::fixnum>::min() == x);
+        if ((0 != y) and (not overflows) and (0 == x % y)) return x / y;
+    }
+    bignum result = a.to_bignum() / b.to_bignum();
+    return result;
+}
+
+number remainder(const number& a, const number& b)
+{
+    if (a.is_fixnum() and b.is_fixnum() and (0 != b.get_fixnum())) {
+        // % truncates toward zero too. Anything % -1 is 0, but the minimum
+        // % -1 overflows.
+        if (-1 == b.get_fixnum()) return 0;
+        return a.get_fixnum() % b.get_fixnum();
+    }
+
+    bignum n1 = a.to_bignum();
+    bignum n2 = b.to_bignum();
+    bignum quotient = n1 / n2;
+
+    // Truncate toward zero for rational numbers
+    // Convert to integer directly (this truncates toward zero)
+    cpp_int truncated_int = boost::multiprecision::numerator(quotient) /
+                        boost::multiprecision::denominator(quotient);
+
+    // Convert back to bignum (rational)
+    bignum truncated_quotient{truncated_int};
+
+    bignum result = n1 - truncated_quotient * n2;
+    return result;
+}
+
+std::strong_ordering operator<=>(const number& a, const number& b)
+{
+    if (a.is_fixnum() and b.is_fixnum()) return a.get_fixnum() <=> b.get_fixnum();
+    auto x = a.to_bignum();
+    auto y = b.to_bignum();
+    if (x < y) return std::strong_ordering::less;
+    if (x > y) return std::strong_ordering::greater;
+    return std::strong_ordering::equal;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <variant>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "ref_ptr.hpp"
+
+using bignum = boost::multiprecision::cpp_rational;
+
+// Noeval numbers are exact rationals.
+//
+// Most numbers are small integers, though--loop counters, lengths,
+// codepoints--so those are kept in a machine word (a fixnum), and a bignum is
+// only used for numbers that aren't integers or don't fit. Fixnum arithmetic
+// that would overflow, and division that doesn't come out even, is done with
+// bignums instead. Any result that fits in a fixnum is made one, so a number
+// has only one representation, and a fixnum never equals a bignum.
+//
+// A bignum is boxed, so a number is only twice the size of a fixnum.
+class number final {
+public:
+    using fixnum = std::int64_t;
+
+    number(): rep{fixnum{0}} {}
+
+    template<std::integral T>
+    number(T n)
+    {
+        if constexpr (std::unsigned_integral<T> and (sizeof(T) >= sizeof(fixnum))) {
+            if (n > static_cast<T>(std::numeric_limits<fixnum>::max())) {
+                rep = boxed<bignum>{bignum{n}};
+                return;
+            }
+        }
+        rep = static_cast<fixnum>(n);
+    }
+
+    number(const bignum& n);
+    number(const boost::multiprecision::cpp_int& n): number{bignum{n}} {}
+
+    bool is_fixnum() const { return std::holds_alternative<fixnum>(rep); }
+    // Only for numbers where is_fixnum() is true
+    fixnum get_fixnum() const { return std::get<fixnum>(rep); }
+    bool is_integer() const;
+    bignum to_bignum() const;
+
+    number numerator() const;
+    number denominator() const;
+
+    friend number operator+(const number& a, const number& b);
+    friend number operator-(const number& a, const number& b);
+    friend number operator*(const number& a, const number& b);
+    // Throws on division by zero
+    friend number operator/(const number& a, const number& b);
+    // a - truncate(a / b) * b
+    friend number remainder(const number& a, const number& b);
+
+    friend bool operator==(const number& a, const number& b) = default;
+    friend std::strong_ordering operator<=>(const number& a, const number& b);
+
+private:
+    std::variant<fixnum, boxed<bignum>> rep;
+
+    const bignum& get_bignum() const { return std::get<boxed<bignum>>(rep).get(); }
+};
+
+static_assert(sizeof(number) <= 16);
@@ -1,4 +1,5 @@
 #include <cctype>
+#include <charconv>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -492,7 +493,7 @@ value_ptr parser::parse_list()
     
     if (current_token.type == token_type::right_paren) {
         advance(); // consume ')'
-        return value::make(nullptr); // nil
+        return constant_pool::nil(); // nil
     }
     
     // Parse elements
@@ -517,7 +518,7 @@ value_ptr parser::parse_list()
     advance(); // consume ')'
     
     // Build cons cells from right to left
-    value_ptr result = value::make(nullptr); // nil
+    value_ptr result = constant_pool::nil(); // nil
     for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
         result = value::make(cons_cell{*it, result});
     }
@@ -530,7 +531,7 @@ parser::parser(std::string input) : lex(std::move(input))
     advance(); // prime the pump
 }
 
-bignum parse_number_string(const std::string& num_str)
+number parse_number_string(const std::string& num_str)
 {
     using cpp_int = boost::multiprecision::cpp_int;
     
@@ -673,7 +674,7 @@ bignum parse_number_string(const std::string& num_str)
             repeating_value = -repeating_value;
         }
         
-        return base_value + repeating_value;
+        return bignum(base_value + repeating_value);
     }
     
     // Check if it's a regular decimal
@@ -701,7 +702,11 @@ bignum parse_number_string(const std::string& num_str)
     }
     
     // Simple integer
-    return bignum(cpp_int(num_str));
+    // Most fit in a fixnum, which doesn't need a bignum to be parsed first.
+    number::fixnum small{0};
+    auto [end, error] = std::from_chars(num_str.data(), num_str.data() + num_str.size(), small);
+    if ((std::errc{} == error) and (num_str.data() + num_str.size() == end)) return small;
+    return cpp_int(num_str);
 }
 
 value_ptr parser::parse_expression()
@@ -715,6 +720,8 @@ value_ptr parser::parse_expression()
         case token_type::symbol:
             {
                 NOEVAL_DEBUG(parse, "Parsing symbol: {}", current_token.value);
+                // Constructing the symbol interns its name, so this is the
+                // only time the string is hashed.
                 auto result = value::make(symbol{current_token.value});
                 advance();
                 return result;
@@ -723,8 +730,7 @@ value_ptr parser::parse_expression()
         case token_type::number:
             {
                 NOEVAL_DEBUG(parse, "Parsing number: {}", current_token.value);
-                bignum val = parse_number_string(current_token.value);
-                auto result = value::make(val);
+                auto result = constant_pool::make_number(parse_number_string(current_token.value));
                 advance();
                 return result;
             }
@@ -732,13 +738,13 @@ value_ptr parser::parse_expression()
         case token_type::string_literal:
             {
                 NOEVAL_DEBUG(parse, "Parsing string literal: {}", current_token.value);
-                auto result = value::make(current_token.value);
+                auto result = constant_pool::make_literal(current_token.value);
                 advance();
                 return result;
             }
             
         case token_type::eof:
-            return value::make(eof_object{});
+            return constant_pool::eof();
             
         default:
             throw std::runtime_error("Unexpected token");
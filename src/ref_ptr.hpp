@@ -0,0 +1,168 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "allocation.hpp"
+
+// Intrusive reference counting for values and environments
+//
+// These replace std::shared_ptr. The count lives in the object itself, so
+// making an object is one allocation instead of two, there's no control block,
+// and a raw pointer to an object can always be turned back into a ref_ptr
+// (which is what enable_shared_from_this was for). The interpreter is
+// single-threaded, so the count isn't atomic.
+//
+// There are no weak references. The environment registry that used to hold
+// weak_ptrs is now a list through the environments themselves, and
+// environments remove themselves from it when they are destroyed.
+
+// Base class for objects managed by ref_ptr
+//
+// A class can also keep its own count instead, where a base class would waste
+// space: a mutable std::uint32_t ref_count and a use_count() function, with
+// ref_ptr as a friend. (See value.)
+class ref_counted {
+public:
+    std::uint32_t use_count() const { return ref_count; }
+
+protected:
+    ref_counted() = default;
+    // A copy is a new object, so it starts out unreferenced.
+    ref_counted(const ref_counted&) {}
+    ref_counted& operator=(const ref_counted&) { return *this; }
+    ~ref_counted() = default;
+
+private:
+    template<typename T> friend class ref_ptr;
+    mutable std::uint32_t ref_count{0};
+};
+
+// A pointer that shares ownership of a ref_counted object, with the parts of
+// std::shared_ptr's interface that we use.
+//
+// When the last reference goes away, the object is destroyed with
+// ref_ptr_delete(T*), which must be declared for T. That lets ref_ptr be used
+// with types that are incomplete where it is instantiated, as std::shared_ptr
+// could.
+template<typename T>
+class ref_ptr final {
+public:
+    using element_type = T;
+
+    ref_ptr() noexcept = default;
+    ref_ptr(std::nullptr_t) noexcept {}
+    explicit ref_ptr(T* p) noexcept: ptr{p} { retain(); }
+
+    ref_ptr(const ref_ptr& that) noexcept: ptr{that.ptr} { retain(); }
+    ref_ptr(ref_ptr&& that) noexcept: ptr{std::exchange(that.ptr, nullptr)} {}
+
+    ref_ptr& operator=(const ref_ptr& that) noexcept
+    {
+        ref_ptr{that}.swap(*this);
+        return *this;
+    }
+
+    ref_ptr& operator=(ref_ptr&& that) noexcept
+    {
+        ref_ptr{std::move(that)}.swap(*this);
+        return *this;
+    }
+
+    ref_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~ref_ptr() { release(); }
+
+    T* get() const noexcept { return ptr; }
+    T& operator*() const noexcept { return *ptr; }
+    T* operator->() const noexcept { return ptr; }
+    explicit operator bool() const noexcept { return nullptr != ptr; }
+    std::uint32_t use_count() const noexcept { return ptr? ptr->use_count(): 0; }
+
+    void reset() noexcept { ref_ptr{}.swap(*this); }
+    void swap(ref_ptr& that) noexcept { std::swap(ptr, that.ptr); }
+
+    friend bool operator==(const ref_ptr& lhs, const ref_ptr& rhs) noexcept
+    { return lhs.ptr == rhs.ptr; }
+    friend bool operator==(const ref_ptr& lhs, std::nullptr_t) noexcept
+    { return nullptr == lhs.ptr; }
+    friend std::strong_ordering operator<=>(const ref_ptr& lhs, const ref_ptr& rhs) noexcept
+    { return std::compare_three_way{}(lhs.ptr, rhs.ptr); }
+
+private:
+    T* ptr{nullptr};
+
+    void retain() noexcept
+    {
+        if (ptr) ++ptr->ref_count;
+    }
+
+    void release() noexcept
+    {
+        if (ptr and (0 == --ptr->ref_count)) ref_ptr_delete(ptr);
+    }
+};
+
+template<typename T>
+struct std::hash<ref_ptr<T>> {
+    std::size_t operator()(const ref_ptr<T>& p) const noexcept
+    { return std::hash<T*>{}(p.get()); }
+};
+
+// An immutable T on the heap, shared by copies
+//
+// This keeps big payloads that are rarely used out of the types that hold
+// them, so those can be small (see value and number). Copying a boxed<T> just
+// adds a reference. There's no way to change the T; to change one, copy it out,
+// change the copy, and box that.
+template<typename T>
+class boxed final {
+public:
+    using element_type = T;
+
+    boxed(T payload): node{new box_node{std::move(payload)}} {}
+
+    const T& get() const noexcept { return node->payload; }
+    const T& operator*() const noexcept { return node->payload; }
+    const T* operator->() const noexcept { return &node->payload; }
+    operator const T&() const noexcept { return node->payload; }
+
+    // The size of the allocation that holds the T
+    static constexpr std::size_t node_size();
+
+    std::string to_string() const
+        requires requires(const T& t) { t.to_string(); }
+    { return get().to_string(); }
+
+    friend bool operator==(const boxed& lhs, const boxed& rhs)
+    { return lhs.get() == rhs.get(); }
+
+private:
+    struct box_node final: ref_counted {
+        T payload;
+        explicit box_node(T p): payload(std::move(p)) {}
+
+        static void* operator new(std::size_t size) { return pool_allocate(size); }
+        static void operator delete(void* p, std::size_t size) { pool_deallocate(p, size); }
+
+        friend void ref_ptr_delete(const box_node* n) { delete n; }
+    };
+
+    ref_ptr<const box_node> node;
+};
+
+template<typename T>
+constexpr std::size_t boxed<T>::node_size() { return sizeof(box_node); }
+
+template<typename T> struct is_boxed: std::false_type {};
+template<typename T> struct is_boxed<boxed<T>>: std::true_type {};
+template<typename T> inline constexpr bool is_boxed_v = is_boxed<std::remove_cvref_t<T>>::value;
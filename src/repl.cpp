@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
@@ -11,7 +12,10 @@
 #include <readline/history.h>
 #include <readline/readline.h>
 
+#include "allocation.hpp"
 #include "debug.hpp"
+#include "gc_stats.hpp"
+#include "heap_stats.hpp"
 #include "noeval.hpp"
 #include "parser.hpp"
 #include "repl.hpp"
@@ -218,9 +222,12 @@ bool handle_debug_command(const std::string& input)
         std::println("  :debug colors on/off    - Enable/disable colored output");
         std::println("  :debug stack-depth      - Show max stack depth after each evaluation");
         std::println("  :debug gc               - Show garbage collection info");
-        std::println("  :debug env-counts       - Show environment construction and registration counts");
+        std::println("  :debug env-counts       - Show environment construction (current and max) and registration counts");
+        std::println("  :debug pool-stats       - Show object pool and constant pool usage");
         std::println("");
-        auto categories{debug_categories | std::views::keys | std::ranges::to<std::vector>()};
+        auto categories{debug_categories
+            | std::views::transform(&debug_category_info::name)
+            | std::ranges::to<std::vector>()};
         std::ranges::sort(categories);
         std::println("Categories: {}", categories);
         return true;
@@ -231,7 +238,7 @@ bool handle_debug_command(const std::string& input)
         std::println("  Colors: {}", get_debug().are_colors_enabled()? "enabled": "disabled");
         std::println("  Enabled categories:");
         
-        auto enabled = get_debug().get_enabled_categories() | std::ranges::to<std::vector>();
+        auto enabled = get_debug().get_enabled_categories();
         
         if (enabled.empty()) {
             std::println("    (none)");
@@ -291,8 +298,25 @@ bool handle_debug_command(const std::string& input)
 
     if ("env-counts" == action) {
         std::println("Environment counts:");
-        std::println("  Constructed: {}", environment::get_constructed_count());
-        std::println("  Registered:  {}", environment::get_registered_count());
+        std::println("  Constructed:     {}", environment::get_constructed_count());
+        std::println("  Max constructed: {}", environment::get_peak_constructed_count());
+        std::println("  Registered:      {}", environment::get_registered_count());
+        return true;
+    }
+
+    if ("pool-stats" == action) {
+        auto stats = get_pool_stats();
+        std::println("Object pool:");
+        std::println("  Live objects:  {}", stats.live_objects);
+        std::println("  Live bytes:    {}", stats.live_bytes);
+        std::println("  Free bytes:    {}", stats.free_bytes);
+        std::println("  Empty slabs:   {}", stats.empty_bytes);
+        std::println("  Slab bytes:    {}", stats.reserved_bytes);
+        std::println("  Fragmentation: {:.1f}%", 100 * stats.fragmentation());
+        std::println("Constant pool:");
+        std::println("  Hits:          {}", constant_pool::get_hits());
+        std::println("  Misses:        {}", constant_pool::get_misses());
+        std::println("  Literals:      {}", constant_pool::get_literal_count());
         return true;
     }
 
@@ -300,6 +324,167 @@ bool handle_debug_command(const std::string& input)
     return true;
 }
 
+void print_heap_report(const heap_report& report)
+{
+    auto print_entry = [&report](const heap_entry& e) {
+        std::print("  {:<18} {:>10} {:>10} {:>12}", e.type, e.live, e.peak, e.bytes);
+        if (report.detailed) std::print(" {:>10} {:>12}", e.reached, e.payload_bytes);
+        std::println("");
+    };
+    std::print("  {:<18} {:>10} {:>10} {:>12}", "", "Live", "Peak", "Bytes");
+    if (report.detailed) std::print(" {:>10} {:>12}", "Reached", "Payload");
+    std::println("");
+    std::println("Values:");
+    for (const auto& entry: report.values) print_entry(entry);
+    std::println("Environments:");
+    print_entry(report.environments);
+    std::println("  Total bytes: {}", report.total_bytes());
+    std::println("  Object pool: {} live objects, {} live bytes, {} slab bytes",
+        report.pool.live_objects, report.pool.live_bytes, report.pool.reserved_bytes);
+}
+
+// :memory [detailed]
+bool handle_memory_command(const std::string& input)
+{
+    std::istringstream iss(input);
+    std::string command, option;
+    iss >> command >> option;
+    if (":memory" != command) return false;
+
+    if (option.empty() or ("detailed" == option)) {
+        print_heap_report(get_heap_report("detailed" == option));
+    } else {
+        std::println("Usage: :memory [detailed]");
+    }
+    return true;
+}
+
+void print_gc_policy()
+{
+    const auto& policy = environment::get_gc_policy();
+    std::println("Garbage collection:");
+    std::println("  Threshold:   {} environments made since the last collection", policy.allocation_threshold);
+    std::println("  Growth:      {}x the tenured environments the last major collection left", policy.growth_ratio);
+    std::println("  Min heap:    {} tenured environments before growth counts", policy.minimum_heap);
+    if (0 == policy.parallel_threshold) {
+        std::println("  Parallel:    off");
+    } else {
+        std::println("  Parallel:    major collections of {} environments mark with {} threads",
+            policy.parallel_threshold, policy.get_mark_threads());
+    }
+    auto print_stats = [](std::string_view kind, const collection_stats& stats) {
+        using ms = std::chrono::duration<double, std::milli>;
+        std::println("  {} collections: {} ({:.3f} ms total, {:.3f} ms longest)", kind, stats.count,
+            ms{stats.total_pause}.count(), ms{stats.longest_pause}.count());
+    };
+    print_stats("Minor", environment::get_minor_stats());
+    print_stats("Major", environment::get_major_stats());
+    std::println("  Made since the last collection: {}", environment::get_made_since_collection());
+    std::println("  Tenured environments: {}", environment::get_tenured_count());
+    std::println("  Parallel marks: {}", environment::get_parallel_mark_count());
+    std::println("  Call frames: {} made, {} registered", environment::get_frames_made(),
+        environment::get_frames_registered());
+}
+
+void print_collection_summary(const collection_summary& summary)
+{
+    std::println("{} collections: {}", (collection_kind::minor == summary.kind)? "Minor": "Major",
+        summary.pause.count);
+    if (0 == summary.pause.count) return;
+    using us = std::chrono::duration<double, std::micro>;
+    auto print_times = [](std::string_view name, const time_summary& times) {
+        std::println("  {:<6} p50 {:>9.1f}  p90 {:>9.1f}  p99 {:>9.1f}  max {:>9.1f}  total {:>10.1f} µs",
+            name, us{times.p50}.count(), us{times.p90}.count(), us{times.p99}.count(),
+            us{times.max}.count(), us{times.total}.count());
+    };
+    print_times("Pause", summary.pause);
+    print_times("Mark", summary.mark);
+    print_times("Sweep", summary.sweep);
+    std::println("  Environments marked: {}, freed: {}", summary.marked, summary.freed);
+
+    std::println("  Pauses:");
+    const auto& histogram = summary.histogram;
+    auto used = [](size_t n) { return 0 != n; };
+    auto first = std::ranges::find_if(histogram, used) - histogram.begin();
+    auto last = histogram.rend() - std::ranges::find_if(histogram | std::views::reverse, used);
+    auto most = std::ranges::max(histogram);
+    for (auto bucket = first; bucket < last; ++bucket) {
+        auto label = (bucket + 1 == pause_bucket_count)?
+            std::format(">= {} µs", pause_bucket_floor(bucket).count()):
+            std::format("< {} µs", pause_bucket_floor(bucket + 1).count());
+        std::println("  {:>12} {:<40} {}", label,
+            std::string(histogram[bucket] * 40 / most, '#'), histogram[bucket]);
+    }
+}
+
+// :gc stats
+void print_collection_stats()
+{
+    auto summary = summarize_collections();
+    std::println("Collections in the log: {} ({} older ones dropped)", summary.records, summary.dropped);
+    std::println("Time spent collecting since the first of them: {:.1f}%", 100 * summary.collecting_fraction());
+    print_collection_summary(summary.minor);
+    print_collection_summary(summary.major);
+}
+
+// :gc log, :gc log <file>, or :gc log off
+void handle_gc_log_command(const std::string& file)
+{
+    if (file.empty()) {
+        if (get_collection_file().empty()) {
+            std::println("Collections aren't being written to a file");
+        } else {
+            std::println("Writing collections to {}", get_collection_file());
+        }
+    } else if ("off" == file) {
+        close_collection_file();
+        std::println("Stopped writing collections to a file");
+    } else if (open_collection_file(file)) {
+        std::println("Writing collections to {}", file);
+    } else {
+        std::println("Can't open {}", file);
+    }
+}
+
+// :gc, :gc collect, :gc stats, :gc log ..., or :gc <setting> <value>
+bool handle_gc_command(const std::string& input)
+{
+    std::istringstream iss(input);
+    std::string command, action, setting;
+    iss >> command >> action >> setting;
+    if (":gc" != command) return false;
+
+    if (action.empty()) {
+        print_gc_policy();
+    } else if ("collect" == action) {
+        auto before = environment::get_registered_count();
+        environment::collect();
+        std::println("Collected {} environments", before - environment::get_registered_count());
+    } else if ("stats" == action) {
+        print_collection_stats();
+    } else if ("log" == action) {
+        handle_gc_log_command(setting);
+    } else if ("help" == action) {
+        std::println("Garbage collection commands:");
+        std::println("  :gc                     - Show the collection policy and counts");
+        std::println("  :gc collect             - Collect everything now");
+        std::println("  :gc stats               - Show pause percentiles and histograms of recent collections");
+        std::println("  :gc log <file>          - Write a line for each collection to file (CSV if it ends with .csv,");
+        std::println("                            otherwise JSON lines)");
+        std::println("  :gc log off             - Stop writing them");
+        std::println("  :gc threshold <n>       - Minor collection after n environments are made (0: every time)");
+        std::println("  :gc growth <ratio>      - Major collection when the tenured environments grow by this ratio");
+        std::println("  :gc min-heap <n>        - Don't collect for growth below n tenured environments");
+        std::println("  :gc parallel-threshold <n> - Mark with several threads from n environments (0: never)");
+        std::println("  :gc mark-threads <n>    - Threads for a parallel mark (0: one per core, at most 64)");
+    } else if ((not setting.empty()) and set_gc_option(action, setting)) {
+        std::println("GC {} set to {}", action, setting);
+    } else {
+        std::println("Unknown gc command: {}. Try ':gc help'", input);
+    }
+    return true;
+}
+
 // Check if input is a special command
 bool is_special_command(const std::string& input)
 {
@@ -313,12 +498,23 @@ bool handle_special_command(const std::string& input)
         return true;
     }
 
+    if (handle_memory_command(input)) {
+        return true;
+    }
+
+    if (handle_gc_command(input)) {
+        return true;
+    }
+
     if (":help" == input) {
         std::println("Special commands:");
         std::println("  :help          - Show this help");
         std::println("  :reload        - Recreate the global environment and reload the library (with tests)");
         std::println("  :reload fast   - Recreate the global environment and reload the library (skip tests)");
         std::println("  :debug ...     - Debug control commands (:debug help for details)");
+        std::println("  :gc ...        - Garbage collection policy and control (:gc help for details)");
+        std::println("  :memory        - Show live values and environments by type");
+        std::println("  :memory detailed - Also walk the heap for what's reachable and payload bytes");
         std::println("  quit, exit     - Exit the REPL");
         std::println("");
         std::println("Or enter any Noeval expression to evaluate it.");
@@ -398,7 +594,7 @@ void repl(env_root_ptr env)
         try {
             call_stack_reset_max_depth();
             auto result = eval_expression(input, env);
-            NOEVAL_DEBUG(stack-depth, "max stack depth: {}", call_stack_get_max_depth());
+            NOEVAL_DEBUG(stack_depth, "max stack depth: {}", call_stack_get_max_depth());
             print_result(result);
         } catch (const std::exception& e) {
             print_error(e);
@@ -1,15 +1,70 @@
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <exception>
+#include <limits>
 #include <memory>
 #include <print>
 #include <string>
 
+#include "allocation.hpp"
+#include "debug.hpp"
+#include "gc_stats.hpp"
+#include "heap_stats.hpp"
 #include "noeval.hpp"
 #include "parser.hpp"
 #include "tests.hpp"
 #include "unicode.hpp"
 #include "utils.hpp"
 
+// Helper for tests that check conditions directly
+struct test_checker {
+    int failures = 0;
+
+    void operator()(const std::string& what, bool ok);
+};
+
+void test_checker::operator()(const std::string& what, bool ok)
+{
+    if (ok) {
+        std::println("✓ {}", what);
+    } else {
+        println_red("✗ {}", what);
+        ++failures;
+    }
+}
+
+// Evaluates input in env
+value_ptr eval_string(const std::string& input, const env_root_ptr& env)
+{
+    parser p(input);
+    return eval(p.parse(), env);
+}
+
+// Evaluates input in env and returns how the result prints
+std::string eval_to_string(const std::string& input, const env_root_ptr& env)
+{
+    return value_to_string(eval_string(input, env));
+}
+
+// A policy for tests that only collect when they say to
+constexpr gc_policy collect_on_request{
+    .allocation_threshold = std::numeric_limits<size_t>::max(),
+    .minimum_heap = std::numeric_limits<size_t>::max()};
+
+// Puts the collector's policy back when a test that changes it ends, even
+// if the test throws
+struct saved_gc_policy {
+    gc_policy policy{environment::get_gc_policy()};
+
+    saved_gc_policy() = default;
+    // Uses installed until then
+    explicit saved_gc_policy(const gc_policy& installed) { environment::get_gc_policy() = installed; }
+    saved_gc_policy(const saved_gc_policy&) = delete;
+    saved_gc_policy& operator=(const saved_gc_policy&) = delete;
+    ~saved_gc_policy() { environment::get_gc_policy() = policy; }
+};
+
 // Helper function for running tests
 struct test_runner {
     env_root_ptr env;
@@ -437,6 +492,13 @@ int test_error_conditions()
     runner.test_error("(first 42)", "not a cons cell");
     runner.test_error("(vau x)", "expected 3 arguments");
     runner.test_error("(eval 42)", "expected 2 arguments");
+    runner.test_error("(first 1 2)", "first: expected 1 argument, got 2");
+    runner.test_error("(flush 1)", "expected 0 arguments");
+    runner.test_error("(+)", "expected at least 1 argument");
+    runner.test_error("(try 1)", "expected 2 to 3 arguments");
+    // Church booleans skip operate_operative, but not its checks.
+    runner.test_error("(true 1)", "Wrong number of arguments");
+    runner.test_error("(false 1 2 3)", "Wrong number of arguments");
     
     return runner.failures;
 }
@@ -1269,7 +1331,793 @@ int test_string_primitives()
     return runner.failures;
 }
 
-bool run_tests()
+int test_debug_categories()
+{
+    std::println("\n--- Debug categories ---");
+    test_checker check;
+
+    auto& debug = get_debug();
+    auto saved = debug.get_enabled_categories();
+    debug.disable_all();
+
+    debug.enable("gc");
+    check("enable sets the category", debug.is_enabled(debug_category::gc));
+    check("enable leaves other categories alone", not debug.is_enabled(debug_category::eval));
+    debug.enable("stack-depth");
+    check("categories are enabled by user-facing name", debug.is_enabled(debug_category::stack_depth));
+    debug.disable("gc");
+    check("disable clears the category", not debug.is_enabled(debug_category::gc));
+    check("disable leaves other categories alone", debug.is_enabled(debug_category::stack_depth));
+
+    debug.enable("all");
+    check("all enables every category", debug.get_enabled_categories().size() == debug_categories.size());
+    debug.enable("none");
+    check("none disables every category", debug.get_enabled_categories().empty());
+
+    bool threw = false;
+    try {
+        debug.enable("no-such-category");
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    check("unknown categories are rejected", threw);
+
+    // Arguments must not be evaluated when the category is off.
+    int evaluations = 0;
+    auto expensive = [&]() { ++evaluations; return std::string{"expensive"}; };
+    NOEVAL_DEBUG(eval, "{}", expensive());
+    check("disabled NOEVAL_DEBUG does not evaluate its arguments", 0 == evaluations);
+
+    for (const auto& name: saved) debug.enable(name);
+    return check.failures;
+}
+
+int test_allocation_free_dispatch()
+{
+    std::println("\n--- Allocation-free dispatch ---");
+    auto env = create_top_level_environment();
+    int failures = 0;
+
+    auto count_allocations = [&](const std::string& input) {
+        parser p(input);
+        auto expr = p.parse();
+        // Warm up once so that things like the call stack have capacity.
+        eval(expr, env);
+        allocation_counter counter;
+        eval(expr, env);
+        return counter.count();
+    };
+
+    auto check = [&](const std::string& input, size_t expected) {
+        auto actual = count_allocations(input);
+        if (actual == expected) {
+            std::println("✓ {} => {} allocation(s)", input, actual);
+        } else {
+            println_red("✗ {}: expected {} allocation(s), got {}", input, expected, actual);
+            ++failures;
+        }
+    };
+
+    parser define_x("(define x (cons 1 (cons 2 ())))");
+    eval(define_x.parse(), env);
+
+    size_t result_allocations{0};
+    {
+        allocation_counter counter;
+        auto result = value::make(bignum{3});
+        result_allocations = counter.count();
+    }
+
+    check("(first x)", 0);
+    check("(rest x)", 0);
+    // Small integers come from the constant pool.
+    check("(+ 1 2)", 0);
+    // Otherwise, the only allocations should be for the result value itself.
+    check("(+ 1000 2000)", result_allocations);
+    // Church booleans are shared and select their operand without creating
+    // an environment.
+    check("((nil? x) 1 2)", 0);
+    check("((= 1 1) (first x) 2)", 0);
+    // More operands than fit in the inline buffer still work.
+    parser p("(+ 1 2 3 4 5 6 7 8 9 10)");
+    auto sum = value_to_string(eval(p.parse(), env));
+    if ("55" == sum) {
+        std::println("✓ (+ 1 2 3 4 5 6 7 8 9 10) => 55");
+    } else {
+        println_red("✗ (+ 1 2 3 4 5 6 7 8 9 10): expected 55, got {}", sum);
+        ++failures;
+    }
+
+    return failures;
+}
+
+int test_lexical_addresses()
+{
+    std::println("\n--- Lexical addresses ---");
+    auto env = create_top_level_environment();
+    int failures = 0;
+
+    eval_string("(define outer (vau (a b) e (vau (c) _ (a (b c) (define b 1)))))", env);
+    auto inner = eval_string("(outer 1 2)", env);
+    const auto& op = std::get<boxed<operative>>(inner->data).get();
+
+    // The body is (a (b c) (define b 1))
+    const auto& body = op.body;
+    auto symbol_at = [](const value_ptr& list, size_t n) -> const symbol& {
+        auto current = list;
+        for (; n > 0; --n) current = cdr(current);
+        return std::get<symbol>(car(current)->data);
+    };
+    // An address for some other scope may be left over from analyzing the
+    // outer operative, but it doesn't apply to the inner one's frames.
+    auto check = [&](const std::string& what, const symbol& sym,
+        bool addressed, std::uint32_t depth = 0, std::uint32_t slot = 0)
+    {
+        const auto& address = sym.address;
+        bool ok = addressed?
+            ((address.scope == op.scope) and (address.depth == depth) and (address.slot == slot)):
+            (address.scope != op.scope);
+        if (ok) {
+            std::println("✓ {}: {}", what, sym.name());
+        } else {
+            println_red("✗ {}: {}", what, sym.name());
+            ++failures;
+        }
+    };
+    auto b_c = car(cdr(body));
+    auto define_b = car(cdr(cdr(body)));
+    check("own parameter", symbol_at(b_c, 1), true, 0, 0);
+    check("enclosing parameter", symbol_at(body, 0), true, 1, 0);
+    check("enclosing parameter the body defines", symbol_at(b_c, 0), false);
+    check("free symbol", symbol_at(define_b, 0), false);
+
+    auto another = eval_string("(outer 3 4)", env);
+    if (std::get<boxed<operative>>(another->data)->scope == op.scope) {
+        std::println("✓ operatives created by the same code share a scope");
+    } else {
+        println_red("✗ operatives created by the same code should share a scope");
+        ++failures;
+    }
+
+    return failures;
+}
+
+int test_binding_table()
+{
+    std::println("\n--- Binding table ---");
+    test_checker check;
+
+    // Enough bindings to use the inline storage, the overflow, and the index
+    binding_table table;
+    std::vector<symbol_id> names;
+    std::vector<value_ptr> values;
+    bool all_found{true};
+    for (size_t i{0}; i < 2 * binding_table::index_threshold; ++i) {
+        names.push_back(intern_symbol(std::format("binding-table-{}", i)));
+        values.push_back(value::make(bignum{i}));
+        table.append(names.back(), values.back());
+
+        // Check everything after each append, since the storage changes
+        // as the table grows.
+        for (size_t j{0}; j <= i; ++j) {
+            auto found = table.find(names[j]);
+            all_found = all_found and found and (*found == values[j]) and
+                (table.at(j) == values[j]);
+        }
+    }
+    check("bindings found by name and position as the table grows", all_found);
+    check("unbound name not found", nullptr == table.find(intern_symbol("binding-table-unbound")));
+
+    // Parameters with the same name are allowed; the last one wins.
+    binding_table duplicates;
+    auto x = intern_symbol("x");
+    duplicates.append(x, values[0]);
+    duplicates.append(x, values[1]);
+    check("latest duplicate found", *duplicates.find(x) == values[1]);
+
+    return check.failures;
+}
+
+int test_numbers()
+{
+    std::println("\n--- Numbers ---");
+    test_checker check;
+
+    constexpr auto max = std::numeric_limits<number::fixnum>::max();
+    constexpr auto min = std::numeric_limits<number::fixnum>::min();
+
+    check("small integers are fixnums", number{42}.is_fixnum());
+    check("large unsigned integers are bignums", not number{std::uint64_t{max} + 1}.is_fixnum());
+    check("overflowing addition gives a bignum", not (number{max} + number{1}).is_fixnum());
+    check("overflowing subtraction gives a bignum", not (number{min} - number{1}).is_fixnum());
+    check("overflowing multiplication gives a bignum", not (number{max} * number{2}).is_fixnum());
+    check("min / -1 gives a bignum", not (number{min} / number{-1}).is_fixnum());
+    check("results that fit are fixnums again", ((number{max} + number{1}) - number{1}).is_fixnum());
+    check("exact division gives a fixnum", (number{6} / number{3}).is_fixnum());
+    check("inexact division gives a rational",
+        (number{6} / number{4}) == number{bignum{3, 2}});
+    check("integral rationals are fixnums", number{bignum{4, 2}}.is_fixnum());
+    check("min remainder -1 is 0", remainder(number{min}, number{-1}) == number{0});
+    check("remainder truncates toward zero", remainder(number{-7}, number{2}) == number{-1});
+    check("bignums compare with fixnums", (number{max} + number{1}) > number{max});
+    check("rationals compare with fixnums", number{bignum{1, 2}} < number{1});
+    check("division by zero throws", [] {
+        try {
+            number{1} / number{0};
+        } catch (const std::exception&) {
+            return true;
+        }
+        return false;
+    }());
+    check("fixnums print", "-12" == to_string(number{-12}));
+    check("bignums print", "9223372036854775808" == to_string(number{max} + number{1}));
+
+    return check.failures;
+}
+
+int test_constant_pool()
+{
+    std::println("\n--- Constant pool ---");
+    test_checker check;
+
+    auto hits = constant_pool::get_hits();
+    auto misses = constant_pool::get_misses();
+    check("nil is shared", constant_pool::nil() == constant_pool::nil());
+    check("eof is shared", constant_pool::eof() == constant_pool::eof());
+    check("small integers are shared",
+        constant_pool::make_number(-1) == constant_pool::make_number(-1));
+    check("large integers are not shared",
+        constant_pool::make_number(1'000'000) != constant_pool::make_number(1'000'000));
+    check("rationals are not shared",
+        constant_pool::make_number(bignum{1, 2}) != constant_pool::make_number(bignum{1, 2}));
+    check("hits are counted", constant_pool::get_hits() >= hits + 3);
+    check("misses are counted", constant_pool::get_misses() >= misses + 4);
+
+    parser p("(\"constant pool\" \"constant pool\" 7 7)");
+    auto list = p.parse();
+    auto first_string = car(list);
+    auto second_string = car(cdr(list));
+    check("string literals with the same contents are shared", first_string == second_string);
+    auto first_number = car(cdr(cdr(list)));
+    check("small integer literals are shared", first_number == car(cdr(cdr(cdr(list)))));
+
+    // Like a long-running read loop, keeping everything it reads
+    std::string text;
+    auto distinct = constant_pool::literal_count_max * 3;
+    for (size_t i = 0; i < distinct; ++i) text += std::format("\"line {}\" ", i);
+    parser reader(text);
+    std::vector<value_ptr> read;
+    size_t largest{0};
+    for (size_t i = 0; i < distinct; ++i) {
+        read.push_back(reader.parse());
+        largest = std::max(largest, constant_pool::get_literal_count());
+    }
+    check("reading distinct strings doesn't grow the literal table without limit",
+        largest <= constant_pool::literal_count_max);
+    check("strings read after the table filled are still shared",
+        parser("\"line 0\"").parse() == parser("\"line 0\"").parse());
+    std::string long_literal(constant_pool::literal_length_max + 1, 'x');
+    check("long string literals are not shared",
+        parser(std::format("\"{}\"", long_literal)).parse() !=
+        parser(std::format("\"{}\"", long_literal)).parse());
+
+    return check.failures;
+}
+
+int test_object_pool()
+{
+    std::println("\n--- Object pool ---");
+    test_checker check;
+
+    auto before = get_pool_stats();
+    {
+        // Long enough that destroying it recursively would overflow the stack
+        constexpr size_t length{1'000'000};
+        value_ptr list = value::make(nullptr);
+        for (size_t i{0}; i < length; ++i) {
+            list = value::make(cons_cell{value::make(bignum{i}), list});
+        }
+        auto during = get_pool_stats();
+        check("each value is a live object",
+            during.live_objects == before.live_objects + 2 * length + 1);
+        check("fragmentation is low while the list is alive", during.fragmentation() < 0.1);
+    }
+    auto after = get_pool_stats();
+    check("discarding a long list frees its values", after.live_objects == before.live_objects);
+    check("emptied slabs are kept for reuse", after.empty_bytes > before.empty_bytes);
+    pool_trim();
+    auto trimmed = get_pool_stats();
+    check("pool_trim frees empty slabs",
+        (0 == trimmed.empty_bytes) and (trimmed.reserved_bytes < after.reserved_bytes));
+
+    auto p = pool_allocate(sizeof(value));
+    pool_deallocate(p, sizeof(value));
+    auto q = pool_allocate(sizeof(value));
+    check("a freed block is reused", p == q);
+    pool_deallocate(q, sizeof(value));
+
+    return check.failures;
+}
+
+int test_heap_stats()
+{
+    std::println("\n--- Heap stats ---");
+    test_checker check;
+    auto cons_cells = [](const heap_report& report) {
+        return *std::ranges::find(report.values, "cons-cell", &heap_entry::type);
+    };
+
+    constexpr size_t length{1000};
+    auto before = get_heap_report();
+    {
+        value_ptr list = constant_pool::nil();
+        for (size_t i{0}; i < length; ++i) {
+            list = value::make(cons_cell{constant_pool::nil(), list});
+        }
+        auto during = get_heap_report();
+        check("live values are counted by type",
+            cons_cells(during).live == cons_cells(before).live + length);
+        check("bytes are live objects times their size",
+            cons_cells(during).bytes == cons_cells(during).live * sizeof(value));
+        check("the peak is at least the live count",
+            cons_cells(during).peak >= cons_cells(during).live);
+        check("a cheap report doesn't walk the heap", 0 == cons_cells(during).reached);
+
+        auto env = environment::make();
+        env->define("heap-stats-list", list);
+        env->define("heap-stats-string", value::make(std::string(100, 'x')));
+        auto detailed = get_heap_report(true);
+        check("a detailed report reaches values bound in environments",
+            cons_cells(detailed).reached >= length);
+        auto strings = *std::ranges::find(detailed.values, "string", &heap_entry::type);
+        check("a detailed report counts payload bytes", strings.payload_bytes > 100);
+        check("environments are counted",
+            detailed.environments.live == environment::get_constructed_count());
+    }
+    auto after = get_heap_report();
+    check("destroyed values aren't live", cons_cells(after).live == cons_cells(before).live);
+    check("the peak is kept", cons_cells(after).peak >= cons_cells(before).live + length);
+
+    return check.failures;
+}
+
+int test_root_counts()
+{
+    std::println("\n--- Root counts ---");
+    test_checker check;
+
+    auto root = environment::make();
+    check("a new environment has one root", 1 == root->get_root_count());
+    {
+        auto copy = root;
+        check("copying a root adds one", 2 == root->get_root_count());
+    }
+    check("destroying a copy takes it away", 1 == root->get_root_count());
+
+    auto moved = std::move(root);
+    check("moving a root doesn't change the count", 1 == moved->get_root_count());
+    check("a moved-from root is empty", not root);
+
+    auto other = environment::make(moved);
+    auto other_env = other.get();
+    other = std::move(moved);
+    check("move assignment releases the old root", 0 == other_env->get_root_count());
+    check("move assignment keeps the new root", 1 == other->get_root_count());
+
+    other->define("root-count-test", constant_pool::make_number(1));
+    environment::collect();
+    check("collection keeps what roots refer to", nullptr != other->find_local(intern_symbol("root-count-test")));
+
+    return check.failures;
+}
+
+int test_environment_registry()
+{
+    std::println("\n--- Environment registry ---");
+    test_checker check;
+
+    environment::collect();
+    auto registered = environment::get_registered_count();
+    auto constructed = environment::get_constructed_count();
+    {
+        auto parent = environment::make();
+        auto child = environment::make(parent);
+        check("making environments registers them",
+            environment::get_registered_count() == registered + 2);
+        check("the max constructed count includes them",
+            environment::get_peak_constructed_count() >= constructed + 2);
+    }
+    check("destroying environments unregisters them",
+        environment::get_registered_count() == registered);
+
+    {
+        // A cycle that only collection can break
+        auto env = environment::make();
+        env->define("self", value::make(env));
+    }
+    check("a cycle stays registered until it is collected",
+        environment::get_registered_count() == registered + 1);
+    environment::collect();
+    check("collection unregisters and destroys its garbage",
+        (environment::get_registered_count() == registered) and
+        (environment::get_constructed_count() == constructed));
+
+    size_t allocations;
+    {
+        allocation_counter counter;
+        auto env = environment::make();
+        allocations = counter.count();
+    }
+    check("registering an environment doesn't allocate", 1 == allocations);
+
+    return check.failures;
+}
+
+int test_gc_policy()
+{
+    std::println("\n--- GC policy ---");
+    test_checker check;
+
+    gc_policy policy{.allocation_threshold = 100, .growth_ratio = 2.0, .minimum_heap = 50};
+    using enum collection_kind;
+    check("few new environments don't trigger a collection", none == policy.should_collect(10, 20, 20));
+    check("enough new environments trigger a minor one", minor == policy.should_collect(100, 20, 20));
+    check("tenured growth triggers a major one", major == policy.should_collect(10, 60, 30));
+    check("growth doesn't count below the minimum heap", none == policy.should_collect(10, 40, 10));
+    policy.allocation_threshold = 0;
+    check("a threshold of 0 always collects", minor == policy.should_collect(0, 0, 0));
+
+    saved_gc_policy saved;
+    check("options are parsed", set_gc_option("threshold", "5") and set_gc_option("growth", "1.5"));
+    check("options are applied",
+        (5 == environment::get_gc_policy().allocation_threshold) and
+        (1.5 == environment::get_gc_policy().growth_ratio));
+    check("bad values are rejected",
+        (not set_gc_option("threshold", "five")) and (not set_gc_option("min-heap", "-1")));
+    check("unknown options are rejected", not set_gc_option("frequency", "1"));
+    check("mark threads are limited",
+        set_gc_option("mark-threads", std::to_string(gc_policy::mark_threads_max)) and
+        (not set_gc_option("mark-threads", std::to_string(gc_policy::mark_threads_max + 1))) and
+        (gc_policy::mark_threads_max == environment::get_gc_policy().get_mark_threads()));
+
+    environment::collect();
+    auto collections = environment::get_collection_count();
+    check("nothing new doesn't trigger a collection", not environment::maybe_collect());
+    for (int i{0}; i < 5; ++i) environment::make();
+    check("the threshold triggers a collection", environment::maybe_collect());
+    check("collections are counted", environment::get_collection_count() == collections + 1);
+
+    return check.failures;
+}
+
+int test_safe_points()
+{
+    std::println("\n--- Safe points ---");
+    test_checker check;
+    auto env = create_top_level_environment();
+
+    saved_gc_policy saved{gc_policy{.allocation_threshold = 100}};
+
+    // Each call defines a closure in its own frame (while evaluating the
+    // operands of the tail call), so every frame is in a cycle that only
+    // collection can break. The closure isn't passed on, so the frames aren't
+    // chained together.
+    eval_string("(define spin (wrap (vau (n ignored) () "
+                "((= n 0) 0 (spin (- n 1) (rest (cons (define self (vau () () n)) ())))))))", env);
+    eval_string("(define make-adder (wrap (vau (x) () (wrap (vau (y) () (+ x y))))))", env);
+    environment::collect();
+
+    constexpr size_t iterations{5000};
+    auto registered = environment::get_registered_count();
+    auto collections = environment::get_collection_count();
+    auto result = eval_to_string(std::format("(spin {} 0)", iterations), env);
+    check("a long loop gives the right result", "0" == result);
+    check("a long loop collects at tail calls", environment::get_collection_count() > collections);
+    check("a long loop doesn't keep its frames",
+        environment::get_registered_count() < registered + iterations / 10);
+
+    check("an operative being called is rooted",
+        "5" == eval_to_string("((make-adder 5) (spin 1000 0))", env));
+    check("evaluated operands are rooted",
+        "17" == eval_to_string("((wrap (vau (a b) () (a 10))) (make-adder 7) (spin 1000 0))", env));
+    check("values held by builtins are rooted",
+        "3" == eval_to_string("((first (cons (make-adder 1) (spin 1000 0))) 2)", env));
+
+    return check.failures;
+}
+
+int test_generations()
+{
+    std::println("\n--- Generations ---");
+    test_checker check;
+    // An environment that refers to itself, so only collection can free it
+    auto make_cycle = [] {
+        auto env = environment::make();
+        env->define("self", value::make(env_ptr{env.get()}));
+        return env;
+    };
+
+    saved_gc_policy saved{collect_on_request};
+    environment::collect();
+
+    auto old_env = environment::make();
+    check("new environments are young", not old_env->is_tenured());
+    environment::collect_minor();
+    check("surviving a collection tenures", old_env->is_tenured());
+
+    auto minors = environment::get_minor_stats().count;
+    auto registered = environment::get_registered_count();
+    make_cycle();
+    environment::collect_minor();
+    check("a minor collection collects young garbage", environment::get_registered_count() == registered);
+    check("minor collections are counted", environment::get_minor_stats().count == minors + 1);
+
+    {
+        auto tenured_garbage = make_cycle();
+        environment::collect_minor();
+    }
+    environment::collect_minor();
+    check("a minor collection keeps tenured garbage", environment::get_registered_count() == registered + 1);
+    auto majors = environment::get_major_stats().count;
+    environment::collect();
+    check("a major collection collects it", environment::get_registered_count() == registered);
+    check("major collections are counted", environment::get_major_stats().count == majors + 1);
+
+    {
+        auto young = make_cycle();
+        young->define("x", value::make(number{42}));
+        old_env->define("young", value::make(env_ptr{young.get()}));
+    }
+    check("define into a tenured environment remembers it", 1 == environment::get_remembered_count());
+    environment::collect_minor();
+    auto survived = [&](const value_ptr& v) {
+        auto young = std::get<env_ptr>(v->data);
+        return young->find_local(intern_symbol("x")) and young->is_tenured();
+    };
+    check("environments only a remembered one refers to survive", survived(old_env->lookup("young")));
+    check("the remembered set is emptied", 0 == environment::get_remembered_count());
+
+    auto env = create_top_level_environment();
+    eval_string("(define make-getter (wrap (vau (x) () (vau () () x))))", env);
+    eval_string("(define-mutable getter ())", env);
+    environment::collect();
+    eval_string("(set! getter (make-getter 5))", env);
+    eval_string("(define other-getter (make-getter 7))", env);
+    environment::collect_minor();
+    check("set! into a tenured environment is remembered", "5" == eval_to_string("(getter)", env));
+    check("so are closures defined in one", "7" == eval_to_string("(other-getter)", env));
+
+    return check.failures;
+}
+
+int test_marking_deep_structures(bool stress)
+{
+    std::println("\n--- Marking deep structures ---");
+    test_checker check;
+
+    const size_t depth = stress? 1'000'000: 100'000;
+    auto holder = environment::make();
+    environment::collect();
+    auto registered = environment::get_registered_count();
+    auto traced = environment::get_traced_count();
+    {
+        // An environment at the bottom of a deep list of cells, nested
+        // through both cars and cdrs, and only reachable through them.
+        // Marking and destroying it used to recurse once per cell.
+        auto bottom = environment::make();
+        bottom->define("self", value::make(env_ptr{bottom.get()}));
+        auto deep = value::make(env_ptr{bottom.get()});
+        for (size_t i{0}; i < depth; ++i) {
+            deep = (0 == i % 2)?
+                value::make(cons_cell{deep, constant_pool::nil()}):
+                value::make(cons_cell{constant_pool::make_number(number{i}), deep});
+        }
+        holder->define("deep", deep);
+        // Many references to it mark it once.
+        value_ptr sharing = constant_pool::nil();
+        for (int i{0}; i < 1000; ++i) sharing = value::make(cons_cell{deep, sharing});
+        holder->define("sharing", sharing);
+    }
+
+    environment::collect();
+    // The deep cells, the thousand that share them and the environment
+    check("shared structure is only traced once",
+        environment::get_traced_count() <= traced + depth + 1000 + 2);
+    auto deep = holder->lookup("deep");
+    while (is_cons(car(deep)) or is_cons(cdr(deep))) {
+        deep = is_cons(car(deep))? car(deep): cdr(deep);
+    }
+    check("environments at the bottom of deep structures survive",
+        std::get<env_ptr>(car(deep)->data)->find_local(intern_symbol("self")) and
+        (environment::get_registered_count() == registered + 1));
+
+    holder->define("deep", constant_pool::nil());
+    holder->define("sharing", constant_pool::nil());
+    environment::collect();
+    check("they're collected once nothing refers to them", environment::get_registered_count() == registered);
+    return check.failures;
+}
+
+int test_parallel_mark()
+{
+    std::println("\n--- Parallel mark ---");
+    test_checker check;
+
+    saved_gc_policy saved;
+    environment::get_gc_policy().mark_threads = 4;
+    environment::get_gc_policy().parallel_threshold = 1;
+    constexpr size_t live_count{20000};
+    constexpr size_t shared_count{100};
+    auto holder = environment::make();
+    environment::collect();
+    auto registered = environment::get_registered_count();
+    {
+        // Live environments that all refer to the same ones, so threads race
+        // to mark those, and garbage cycles that refer to them
+        value_ptr shared = constant_pool::nil();
+        for (size_t i{0}; i < shared_count; ++i) {
+            shared = value::make(cons_cell{value::make(environment::make()), shared});
+        }
+        value_ptr list = constant_pool::nil();
+        for (size_t i{0}; i < live_count; ++i) {
+            auto live = (i % 2)? environment::make(holder): environment::make();
+            live->define("n", constant_pool::make_number(number{i}));
+            live->define("shared", shared);
+            list = value::make(cons_cell{value::make(env_ptr{live.get()}), list});
+            auto garbage = environment::make(live);
+            garbage->define("self", value::make(env_ptr{garbage.get()}));
+            garbage->define("live", list);
+        }
+        holder->define("list", list);
+    }
+
+    auto parallel_marks = environment::get_parallel_mark_count();
+    environment::collect();
+    check("big heaps are marked in parallel", environment::get_parallel_mark_count() == parallel_marks + 1);
+    check("garbage is collected",
+        environment::get_registered_count() == registered + live_count + shared_count);
+    size_t intact{0};
+    for (auto list = holder->lookup("list"); is_cons(list); list = cdr(list)) {
+        auto live = std::get<env_ptr>(car(list)->data);
+        if (live->find_local(intern_symbol("n")) and live->find_local(intern_symbol("shared"))) ++intact;
+    }
+    check("live environments are kept", live_count == intact);
+
+    environment::get_gc_policy().parallel_threshold = 0;
+    environment::collect();
+    check("a threshold of 0 doesn't", environment::get_parallel_mark_count() == parallel_marks + 1);
+    check("marking in parallel keeps the same environments",
+        environment::get_registered_count() == registered + live_count + shared_count);
+
+    holder->define("list", constant_pool::nil());
+    environment::get_gc_policy().parallel_threshold = 1;
+    environment::collect();
+    check("they're collected once nothing refers to them", environment::get_registered_count() == registered);
+    return check.failures;
+}
+
+int test_frames()
+{
+    std::println("\n--- Frames ---");
+    test_checker check;
+
+    saved_gc_policy saved{collect_on_request};
+    auto env = create_top_level_environment();
+    eval_string("(define add (wrap (vau (x y) () (+ x y))))", env);
+    eval_string("(define make-getter (wrap (vau (x) () (vau () () x))))", env);
+    eval_string("(define make-cycle (wrap (vau (x) () (define self (vau () () x)))))", env);
+    environment::collect();
+
+    auto registered = environment::get_registered_count();
+    auto made = environment::get_frames_made();
+    auto frames_registered = environment::get_frames_registered();
+    check("calls work", "3" == eval_to_string("(add 1 2)", env));
+    check("calls make frames", environment::get_frames_made() == made + 1);
+    check("frames that don't escape aren't registered",
+        (environment::get_registered_count() == registered) and
+        (environment::get_frames_registered() == frames_registered));
+    check("or counted for collection", 0 == environment::get_made_since_collection());
+
+    eval_string("(define getter (make-getter 5))", env);
+    check("frames that escape are registered", environment::get_frames_registered() == frames_registered + 1);
+    check("and still work", "5" == eval_to_string("(getter)", env));
+    check("and are counted for collection", 1 == environment::get_made_since_collection());
+
+    registered = environment::get_registered_count();
+    eval_string("(make-cycle 7)", env);
+    check("frames in cycles are registered", environment::get_registered_count() == registered + 1);
+    environment::collect();
+    check("so collection can collect them", environment::get_registered_count() == registered);
+
+    {
+        auto frame = environment::make_frame(env_ptr{env.get()}, nullptr);
+        frame->define("frame-only", value::make(std::string{"frame-only"}));
+        check("frames that are roots are listed",
+            std::ranges::contains(environment::get_root_symbols(), "frame-only"));
+        auto report = get_heap_report(true);
+        check("heap reports reach frames",
+            frame->is_frame() and (report.environments.reached == report.environments.live));
+    }
+
+    // With a threshold of 0, every tail call collects, so the frames being
+    // evaluated get registered.
+    environment::get_gc_policy().allocation_threshold = 0;
+    eval_string("(define sum-to (wrap (vau (n total) () ((= n 0) total (sum-to (- n 1) (+ total n))))))", env);
+    check("frames that are live at a collection are kept", "5050" == eval_to_string("(sum-to 100 0)", env));
+    check("collection registers them", environment::get_frames_registered() > frames_registered + 100);
+
+    return check.failures;
+}
+
+int test_collection_telemetry()
+{
+    std::println("\n--- Collection telemetry ---");
+    test_checker check;
+
+    collection_log log;
+    for (size_t i{0}; i < collection_log::capacity + 5; ++i) {
+        log.add({.registry_size = i});
+    }
+    std::vector<size_t> kept;
+    log.for_each([&](const collection_record& record) { kept.push_back(record.registry_size); });
+    check("the log keeps a fixed number of records",
+        (collection_log::capacity == log.size()) and (collection_log::capacity + 5 == log.get_total()));
+    check("it keeps the newest, oldest first",
+        (collection_log::capacity == kept.size()) and (5 == kept.front()) and
+        (collection_log::capacity + 4 == kept.back()));
+
+    saved_gc_policy saved{collect_on_request};
+    environment::collect();
+    auto registered = environment::get_registered_count();
+    {
+        auto env = environment::make();
+        env->define("self", value::make(env));
+    }
+    environment::collect();
+    const collection_record* last{nullptr};
+    environment::get_collection_log().for_each([&](const collection_record& record) { last = &record; });
+    check("collections are recorded",
+        last and (collection_kind::major == last->kind) and (collection_trigger::request == last->trigger));
+    check("with the registry size, and what was marked and freed",
+        (registered + 1 == last->registry_size) and (registered + 1 == last->swept) and
+        (1 == last->freed) and (registered == last->marked));
+    check("and how long marking and sweeping took",
+        (last->pause() == last->mark_time + last->sweep_time) and (last->mark_time.count() > 0));
+
+    environment::get_gc_policy().allocation_threshold = 0;
+    environment::maybe_collect();
+    environment::get_collection_log().for_each([&](const collection_record& record) { last = &record; });
+    check("the reason is recorded",
+        (collection_kind::minor == last->kind) and (collection_trigger::allocation == last->trigger));
+
+    auto summary = summarize_collections();
+    size_t minors{0};
+    environment::get_collection_log().for_each([&](const collection_record& record) {
+        if (collection_kind::minor == record.kind) ++minors;
+    });
+    size_t histogram_total{0};
+    for (auto n: summary.minor.histogram) histogram_total += n;
+    check("summaries count each kind", minors == summary.minor.pause.count);
+    check("histograms count every pause", minors == histogram_total);
+    check("percentiles are in order",
+        (summary.minor.pause.p50 <= summary.minor.pause.p90) and
+        (summary.minor.pause.p90 <= summary.minor.pause.p99) and
+        (summary.minor.pause.p99 <= summary.minor.pause.max));
+
+    collection_record record{
+        .kind = collection_kind::minor, .trigger = collection_trigger::growth,
+        .start = std::chrono::microseconds{10}, .mark_time = std::chrono::nanoseconds{1500},
+        .sweep_time = std::chrono::nanoseconds{500}, .registry_size = 4, .marked = 1, .swept = 3, .freed = 2};
+    check("records can be CSV",
+        "minor,growth,10.000,1.500,0.500,2.000,4,1,3,2" == format_collection_record(record, record_format::csv));
+    check("or JSON",
+        R"({"kind":"minor","trigger":"growth","start_us":10.000,"mark_us":1.500,"sweep_us":0.500,)"
+        R"("pause_us":2.000,"registry":4,"marked":1,"swept":3,"freed":2})" ==
+        format_collection_record(record, record_format::json));
+    return check.failures;
+}
+
+bool run_tests(bool stress)
 {
     // Run existing tests (these could also be converted to return failure counts)
     test_lexer();
@@ -1302,6 +2150,23 @@ bool run_tests()
     failures += test_based_number_edge_cases();
     failures += test_unicode_functions();
     failures += test_string_primitives();
+    failures += test_debug_categories();
+    failures += test_allocation_free_dispatch();
+    failures += test_lexical_addresses();
+    failures += test_binding_table();
+    failures += test_numbers();
+    failures += test_constant_pool();
+    failures += test_object_pool();
+    failures += test_heap_stats();
+    failures += test_root_counts();
+    failures += test_environment_registry();
+    failures += test_gc_policy();
+    failures += test_safe_points();
+    failures += test_generations();
+    failures += test_marking_deep_structures(stress);
+    failures += test_parallel_mark();
+    failures += test_frames();
+    failures += test_collection_telemetry();
     std::println("{}", std::string(60, '='));
 
     if (failures != 0) {
@@ -1,3 +1,5 @@
 #pragma once
 
-bool run_tests();
+// Stress tests use full-size heaps, which takes too long to do on every
+// start.
+bool run_tests(bool stress = false);